@@ -0,0 +1,210 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include "Bench.hpp"
+
+#include <Moe.Core/Exception.hpp>
+#include <Moe.Core/Pal.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#ifndef MOE_WINDOWS
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+using namespace Bench;
+
+//////////////////////////////////////////////////////////////////////////////// Options
+
+Options::Options(int argc, const char* argv[])
+{
+    for (int i = 0; i < argc; ++i)
+    {
+        string arg(argv[i]);
+        if (arg.compare(0, 2, "--") != 0 || arg.size() == 2)
+            MOE_THROW(BadArgumentException, "Unexpected argument \"{0}\"", arg);
+
+        auto pos = arg.find('=');
+        if (pos == string::npos)
+            m_stValues[arg.substr(2)] = "1";
+        else
+            m_stValues[arg.substr(2, pos - 2)] = arg.substr(pos + 1);
+    }
+}
+
+std::string Options::GetString(const std::string& key, const std::string& def)const
+{
+    auto value = Find(key);
+    return value ? *value : def;
+}
+
+uint64_t Options::GetUInt(const std::string& key, uint64_t def)const
+{
+    auto value = Find(key);
+    if (!value)
+        return def;
+
+    char* end = nullptr;
+    auto ret = ::strtoull(value->c_str(), &end, 10);
+    if (value->empty() || *end != '\0')
+        MOE_THROW(BadArgumentException, "Bad integer \"{0}\" for --{1}", *value, key);
+    return ret;
+}
+
+std::vector<uint64_t> Options::GetUIntList(const std::string& key, const std::vector<uint64_t>& def)const
+{
+    auto value = Find(key);
+    if (!value)
+        return def;
+
+    vector<uint64_t> ret;
+    const char* p = value->c_str();
+    while (true)
+    {
+        char* end = nullptr;
+        auto number = ::strtoull(p, &end, 10);
+        if (end == p || (*end != ',' && *end != '\0'))
+            MOE_THROW(BadArgumentException, "Bad integer list \"{0}\" for --{1}", *value, key);
+        ret.push_back(number);
+        if (*end == '\0')
+            break;
+        p = end + 1;
+    }
+    return ret;
+}
+
+std::vector<std::string> Options::GetStringList(const std::string& key, const std::vector<std::string>& def)const
+{
+    auto value = Find(key);
+    if (!value)
+        return def;
+
+    vector<string> ret;
+    size_t begin = 0;
+    while (true)
+    {
+        auto end = value->find(',', begin);
+        auto item = value->substr(begin, end == string::npos ? string::npos : end - begin);
+        if (item.empty())
+            MOE_THROW(BadArgumentException, "Bad list \"{0}\" for --{1}", *value, key);
+        ret.push_back(std::move(item));
+        if (end == string::npos)
+            break;
+        begin = end + 1;
+    }
+    return ret;
+}
+
+bool Options::GetBool(const std::string& key, bool def)const
+{
+    auto value = Find(key);
+    if (!value)
+        return def;
+    if (*value == "1" || *value == "true" || *value == "on")
+        return true;
+    if (*value == "0" || *value == "false" || *value == "off")
+        return false;
+    MOE_THROW(BadArgumentException, "Bad boolean \"{0}\" for --{1}", *value, key);
+}
+
+void Options::CheckUnused()const
+{
+    for (const auto& pair : m_stValues)
+    {
+        if (m_stUsed.find(pair.first) == m_stUsed.end())
+            MOE_THROW(BadArgumentException, "Unknown option --{0}", pair.first);
+    }
+}
+
+const std::string* Options::Find(const std::string& key)const
+{
+    m_stUsed.insert(key);
+    auto it = m_stValues.find(key);
+    return it == m_stValues.end() ? nullptr : &it->second;
+}
+
+//////////////////////////////////////////////////////////////////////////////// Report
+
+void Report::SetColumns(std::vector<std::string> columns, const std::vector<size_t>& widths)
+{
+    m_stColumns = std::move(columns);
+    m_stWidths.clear();
+    for (size_t i = 0; i < m_stColumns.size(); ++i)
+    {
+        auto width = i < widths.size() ? widths[i] : 10;
+        m_stWidths.push_back(std::max(m_stColumns[i].size(), width));
+    }
+
+    AddRow(m_stColumns);
+}
+
+void Report::AddRow(const std::vector<std::string>& row)
+{
+    for (size_t i = 0; i < row.size(); ++i)
+    {
+        if (m_bCsv)
+            ::printf("%s%s", i == 0 ? "" : ",", row[i].c_str());
+        else
+        {
+            auto width = i < m_stWidths.size() ? m_stWidths[i] : 0;
+            ::printf("%s%*s", i == 0 ? "" : "  ", static_cast<int>(width), row[i].c_str());
+        }
+    }
+    ::printf("\n");
+    ::fflush(stdout);
+}
+
+//////////////////////////////////////////////////////////////////////////////// 工具函数
+
+std::string Bench::FormatUInt(uint64_t value)
+{
+    char buf[32];
+    ::snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(value));
+    return buf;
+}
+
+std::string Bench::FormatDouble(double value, int precision)
+{
+    char buf[64];
+    ::snprintf(buf, sizeof(buf), "%.*f", precision, value);
+    return buf;
+}
+
+std::string Bench::FormatMicros(uint64_t nanos)
+{
+    return FormatDouble(static_cast<double>(nanos) / 1000., 1);
+}
+
+void Bench::AppendLatencyColumns(std::vector<std::string>& row, const LatencyHistogram& histogram)
+{
+    row.push_back(FormatMicros(histogram.GetPercentile(50)));
+    row.push_back(FormatMicros(histogram.GetPercentile(99)));
+    row.push_back(FormatMicros(histogram.GetPercentile(99.9)));
+    row.push_back(FormatMicros(histogram.GetMax()));
+}
+
+uint64_t Bench::RaiseFdLimit(uint64_t want)noexcept
+{
+#ifndef MOE_WINDOWS
+    ::rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) != 0)
+        return 0;
+    if (limit.rlim_cur >= want)
+        return limit.rlim_cur;
+
+    auto target = limit.rlim_max == RLIM_INFINITY ? want : std::min<uint64_t>(want, limit.rlim_max);
+    limit.rlim_cur = target;
+    if (::setrlimit(RLIMIT_NOFILE, &limit) != 0)
+        ::getrlimit(RLIMIT_NOFILE, &limit);
+    return limit.rlim_cur;
+#else
+    return want;
+#endif
+}
@@ -0,0 +1,151 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include <Moe.UV/RunLoopStats.hpp>
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace moe
+{
+namespace UV
+{
+namespace Bench
+{
+    /**
+     * @brief 命令行参数
+     *
+     * 参数格式为--key=value，列表以逗号分隔，--key等价于--key=1。
+     */
+    class Options
+    {
+    public:
+        Options() = default;
+        Options(int argc, const char* argv[]);
+
+    public:
+        /**
+         * @brief 是否指定了参数
+         */
+        bool Has(const std::string& key)const { return Find(key) != nullptr; }
+
+        /**
+         * @brief 获取字符串参数
+         */
+        std::string GetString(const std::string& key, const std::string& def)const;
+
+        /**
+         * @brief 获取整数参数
+         */
+        uint64_t GetUInt(const std::string& key, uint64_t def)const;
+
+        /**
+         * @brief 获取整数列表参数
+         */
+        std::vector<uint64_t> GetUIntList(const std::string& key, const std::vector<uint64_t>& def)const;
+
+        /**
+         * @brief 获取字符串列表参数
+         */
+        std::vector<std::string> GetStringList(const std::string& key, const std::vector<std::string>& def)const;
+
+        /**
+         * @brief 获取布尔参数
+         */
+        bool GetBool(const std::string& key, bool def)const;
+
+        /**
+         * @brief 检查是否存在未被读取过的参数
+         *
+         * 应在读取完所有参数后调用，用于拒绝拼写错误的参数。
+         */
+        void CheckUnused()const;
+
+    private:
+        const std::string* Find(const std::string& key)const;
+
+    private:
+        std::map<std::string, std::string> m_stValues;
+        mutable std::set<std::string> m_stUsed;
+    };
+
+    /**
+     * @brief 结果表格
+     *
+     * 以对齐的表格或CSV输出，CSV便于与历史结果比对。
+     */
+    class Report
+    {
+    public:
+        explicit Report(bool csv)noexcept
+            : m_bCsv(csv) {}
+
+    public:
+        /**
+         * @brief 设置表头并输出
+         * @param columns 列名
+         * @param widths 各列的最小宽度，缺省时按列名宽度且不少于10
+         */
+        void SetColumns(std::vector<std::string> columns, const std::vector<size_t>& widths={});
+
+        /**
+         * @brief 输出一行
+         */
+        void AddRow(const std::vector<std::string>& row);
+
+    private:
+        bool m_bCsv = false;
+        std::vector<std::string> m_stColumns;
+        std::vector<size_t> m_stWidths;
+    };
+
+    /**
+     * @brief 格式化整数
+     */
+    std::string FormatUInt(uint64_t value);
+
+    /**
+     * @brief 格式化浮点数
+     */
+    std::string FormatDouble(double value, int precision=2);
+
+    /**
+     * @brief 以微秒格式化纳秒时长
+     */
+    std::string FormatMicros(uint64_t nanos);
+
+    /**
+     * @brief 将延迟直方图格式化为p50/p99/p999/max四列（微秒）
+     */
+    void AppendLatencyColumns(std::vector<std::string>& row, const LatencyHistogram& histogram);
+
+    /**
+     * @brief 尝试提升文件描述符上限
+     * @param want 期望的上限
+     * @return 实际的上限
+     */
+    uint64_t RaiseFdLimit(uint64_t want)noexcept;
+
+    /**
+     * @brief TCP回显：连接数、消息大小、RunLoop数扫描，报告吞吐和往返延迟
+     */
+    int RunTcpEchoBench(const Options& options);
+
+    /**
+     * @brief UDP收发：发送方式、包大小、套接字数、RunLoop数扫描，报告收发包速率和丢包率
+     */
+    int RunUdpBench(const Options& options);
+
+    /**
+     * @brief 微基准：句柄创建关闭、定时器、跨线程唤醒、线程池、地址解析与格式化、DNS
+     */
+    int RunMicroBench(const Options& options);
+}
+}
+}
@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include "Bench.hpp"
+
+#include <Moe.Core/Exception.hpp>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+using namespace Bench;
+
+namespace
+{
+    struct Suite
+    {
+        const char* Name;
+        const char* Description;
+        int (*Run)(const Options& options);
+    };
+
+    const Suite kSuites[] = {
+        { "tcp-echo", "TCP ping-pong over loopback, sweeping connections, message sizes and loops", RunTcpEchoBench },
+        { "udp", "UDP packets per second and drop rate, comparing Send, SendNoCopy and TrySend", RunUdpBench },
+        { "micro", "Per-operation cost of handles, timers, cross-thread wakeups, EndPoint and Dns", RunMicroBench },
+    };
+
+    void PrintUsage(const char* program)
+    {
+        ::printf("Usage: %s <suite> [--key=value ...]\n\nSuites:\n", program);
+        for (const auto& suite : kSuites)
+            ::printf("  %-12s %s\n", suite.Name, suite.Description);
+        ::printf("\nCommon options:\n  --csv        print results as CSV\n");
+    }
+}
+
+int main(int argc, const char* argv[])
+{
+    if (argc < 2 || ::strcmp(argv[1], "--help") == 0)
+    {
+        PrintUsage(argv[0]);
+        return argc < 2 ? 1 : 0;
+    }
+
+    for (const auto& suite : kSuites)
+    {
+        if (::strcmp(argv[1], suite.Name) != 0)
+            continue;
+
+        try
+        {
+            Options options(argc - 2, argv + 2);
+            return suite.Run(options);
+        }
+        catch (const std::exception& ex)
+        {
+            ::fprintf(stderr, "error: %s\n", ex.what());
+            return 1;
+        }
+    }
+
+    ::fprintf(stderr, "error: unknown suite \"%s\"\n\n", argv[1]);
+    PrintUsage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,379 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include "Bench.hpp"
+
+#include <Moe.UV/AsyncNotifier.hpp>
+#include <Moe.UV/Dns.hpp>
+#include <Moe.UV/RunLoop.hpp>
+#include <Moe.UV/TcpSocket.hpp>
+#include <Moe.UV/ThreadPool.hpp>
+#include <Moe.UV/Timer.hpp>
+
+#include <Moe.Core/Exception.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <thread>
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+using namespace Bench;
+
+namespace
+{
+    const uint64_t kMaxIterations = 1000000000ull;
+    const uint64_t kChurnBatch = 1024;  // Create/Close若干次后驱动一次RunLoop以回收句柄
+    const Time::Tick kIdleTimerTimeout = 3600 * 1000;  // 测试期间不会触发的超时时间
+
+    volatile size_t g_uSink = 0;  // 防止被测代码被优化掉
+
+    /**
+     * @brief 单次运行的状态
+     *
+     * 测试函数负责完成GetIterations次操作，并用StartTiming/StopTiming包围被测部分，
+     * 异步往返类测试可额外记录每次操作的延迟。
+     */
+    class MicroState
+    {
+    public:
+        explicit MicroState(uint64_t iterations)noexcept
+            : m_ullIterations(iterations) {}
+
+    public:
+        uint64_t GetIterations()const noexcept { return m_ullIterations; }
+        uint64_t GetElapsed()const noexcept { return m_ullElapsed; }
+
+        bool HasLatency()const noexcept { return m_stLatency.GetCount() != 0; }
+        const LatencyHistogram& GetLatency()const noexcept { return m_stLatency; }
+
+        void StartTiming()noexcept { m_ullBegin = RunLoop::NowNanos(); }
+        void StopTiming()noexcept { m_ullElapsed += RunLoop::NowNanos() - m_ullBegin; }
+        void RecordLatency(uint64_t nanos)noexcept { m_stLatency.Record(nanos); }
+
+    private:
+        uint64_t m_ullIterations = 0;
+        uint64_t m_ullBegin = 0;
+        uint64_t m_ullElapsed = 0;
+        LatencyHistogram m_stLatency;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////// 句柄
+
+    void BenchTcpCreateClose(MicroState& state)
+    {
+        ObjectPool pool;
+        RunLoop loop(pool);
+
+        state.StartTiming();
+        for (uint64_t i = 0; i < state.GetIterations(); ++i)
+        {
+            auto socket = TcpSocket::Create();
+            socket.Close();
+            if (i % kChurnBatch == kChurnBatch - 1)
+                loop.RunOnce(false);
+        }
+        loop.Run();
+        state.StopTiming();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////// 定时器
+
+    /**
+     * @brief 在Active个活动定时器的背景下测试定时器操作
+     * @tparam Active 背景中的活动定时器数量
+     * @tparam Reset 为true时对活动定时器重新Start，否则对一个额外的定时器Start后Stop
+     */
+    template <unsigned Active, bool Reset>
+    void BenchTimer(MicroState& state)
+    {
+        ObjectPool pool;
+        RunLoop loop(pool);
+
+        vector<Timer> timers;
+        timers.reserve(Active + 1);
+        for (unsigned i = 0; i <= Active; ++i)
+        {
+            timers.emplace_back(Timer::Create());
+            timers.back().SetFirstTime(kIdleTimerTimeout + i);
+            if (i < Active)
+                timers.back().Start();
+        }
+
+        state.StartTiming();
+        for (uint64_t i = 0; i < state.GetIterations(); ++i)
+        {
+            if (Reset)
+            {
+                auto& timer = timers[i % Active];
+                timer.SetFirstTime(kIdleTimerTimeout + i % (Active * 2));
+                timer.Start();
+            }
+            else
+            {
+                auto& timer = timers[Active];
+                timer.Start();
+                timer.Stop();
+            }
+        }
+        state.StopTiming();
+
+        for (auto& timer : timers)
+            timer.Close();
+        loop.Run();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////// 跨线程
+
+    void BenchNotifyRoundTrip(MicroState& state)
+    {
+        ObjectPool pool;
+        RunLoop loop(pool);
+
+        promise<AsyncNotifier*> ready;
+        atomic<bool> done { false };
+        auto pong = AsyncNotifier::Create();
+
+        // 对端线程收到通知后立即回复
+        thread peer([&]() {
+            ObjectPool peerPool;
+            RunLoop peerLoop(peerPool);
+
+            auto ping = AsyncNotifier::Create();
+            ping.SetOnAsyncCallback([&]() {
+                if (done.load(memory_order_acquire))
+                    ping.Close();
+                else
+                    pong.Notify();
+            });
+            ready.set_value(&ping);
+            peerLoop.Run();
+        });
+        auto ping = ready.get_future().get();
+
+        uint64_t remaining = state.GetIterations();
+        uint64_t sentAt = 0;
+        pong.SetOnAsyncCallback([&]() {
+            state.RecordLatency(RunLoop::NowNanos() - sentAt);
+            if (--remaining == 0)
+            {
+                pong.Close();
+                done.store(true, memory_order_release);
+            }
+            else
+                sentAt = RunLoop::NowNanos();
+            ping->Notify();
+        });
+
+        state.StartTiming();
+        sentAt = RunLoop::NowNanos();
+        ping->Notify();
+        loop.Run();
+        state.StopTiming();
+        peer.join();
+    }
+
+    void BenchThreadPoolRoundTrip(MicroState& state)
+    {
+        ObjectPool pool;
+        RunLoop loop(pool);
+
+        uint64_t remaining = state.GetIterations();
+        uint64_t sentAt = 0;
+        function<void()> queue = [&]() {
+            sentAt = RunLoop::NowNanos();
+            ThreadPool::QueueWork([](void*) {}, [&](int, void*) {
+                state.RecordLatency(RunLoop::NowNanos() - sentAt);
+                if (--remaining != 0)
+                    queue();
+            });
+        };
+
+        state.StartTiming();
+        queue();
+        loop.Run();
+        state.StopTiming();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////// 地址
+
+    void BenchEndPointParseIpv4(MicroState& state)
+    {
+        state.StartTiming();
+        for (uint64_t i = 0; i < state.GetIterations(); ++i)
+        {
+            EndPoint address("192.168.100.200", 8080);
+            g_uSink += address.Storage.ss_family;
+        }
+        state.StopTiming();
+    }
+
+    void BenchEndPointParseIpv6(MicroState& state)
+    {
+        state.StartTiming();
+        for (uint64_t i = 0; i < state.GetIterations(); ++i)
+        {
+            EndPoint address("fe80::1234:5678:9abc:def0", 8080);
+            g_uSink += address.Storage.ss_family;
+        }
+        state.StopTiming();
+    }
+
+    void BenchEndPointFormatIpv4(MicroState& state)
+    {
+        EndPoint address("192.168.100.200", 8080);
+
+        state.StartTiming();
+        for (uint64_t i = 0; i < state.GetIterations(); ++i)
+            g_uSink += address.ToString().size();
+        state.StopTiming();
+    }
+
+    void BenchEndPointFormatIpv6(MicroState& state)
+    {
+        EndPoint address("fe80::1234:5678:9abc:def0", 8080);
+
+        state.StartTiming();
+        for (uint64_t i = 0; i < state.GetIterations(); ++i)
+            g_uSink += address.ToString().size();
+        state.StopTiming();
+    }
+
+    void BenchDnsResolveHosts(MicroState& state)
+    {
+        ObjectPool pool;
+        RunLoop loop(pool);
+
+        uint64_t remaining = state.GetIterations();
+        uint64_t sentAt = 0;
+        int error = 0;
+        function<void()> resolve = [&]() {
+            sentAt = RunLoop::NowNanos();
+            Dns::Resolve("localhost", [&](int status, const EndPoint&) {
+                state.RecordLatency(RunLoop::NowNanos() - sentAt);
+                if (status != 0)
+                    error = status;
+                else if (--remaining != 0)
+                    resolve();
+            });
+        };
+
+        state.StartTiming();
+        resolve();
+        loop.Run();
+        state.StopTiming();
+
+        if (error != 0)
+            MOE_THROW(ApiException, "Resolve localhost failed with {0}", error);
+    }
+
+    struct Benchmark
+    {
+        const char* Name;
+        void (*Run)(MicroState& state);
+    };
+
+    const Benchmark kBenchmarks[] = {
+        { "tcp/create-close", BenchTcpCreateClose },
+        { "timer/start-stop/1", BenchTimer<1, false> },
+        { "timer/start-stop/1000", BenchTimer<1000, false> },
+        { "timer/start-stop/100000", BenchTimer<100000, false> },
+        { "timer/reset/1", BenchTimer<1, true> },
+        { "timer/reset/1000", BenchTimer<1000, true> },
+        { "timer/reset/100000", BenchTimer<100000, true> },
+        { "notify/round-trip", BenchNotifyRoundTrip },
+        { "thread-pool/round-trip", BenchThreadPoolRoundTrip },
+        { "endpoint/parse-ipv4", BenchEndPointParseIpv4 },
+        { "endpoint/parse-ipv6", BenchEndPointParseIpv6 },
+        { "endpoint/format-ipv4", BenchEndPointFormatIpv4 },
+        { "endpoint/format-ipv6", BenchEndPointFormatIpv6 },
+        { "dns/resolve-hosts", BenchDnsResolveHosts },
+    };
+
+    /**
+     * @brief 逐步放大迭代次数直到单次运行时间不少于minTime
+     */
+    MicroState RunBenchmark(const Benchmark& benchmark, uint64_t minTime)
+    {
+        uint64_t iterations = 1;
+        while (true)
+        {
+            MicroState state(iterations);
+            benchmark.Run(state);
+
+            auto elapsed = std::max<uint64_t>(state.GetElapsed(), 1);
+            if (elapsed >= minTime || iterations >= kMaxIterations)
+                return state;
+
+            // 按已测得的速度预估，多估40%以减少重跑次数，且单次最多放大10倍
+            auto predicted = static_cast<uint64_t>(static_cast<double>(iterations) * 1.4 *
+                static_cast<double>(minTime) / static_cast<double>(elapsed));
+            iterations = std::min(kMaxIterations, std::max(iterations + 1, std::min(predicted, iterations * 10)));
+        }
+    }
+}
+
+int Bench::RunMicroBench(const Options& options)
+{
+    if (options.Has("help"))
+    {
+        ::printf(
+            "Options:\n"
+            "  --filter=TEXT     only run benchmarks whose name contains TEXT\n"
+            "  --min-time=MS     minimum measuring time per benchmark (default 500)\n"
+            "  --list            list benchmarks and exit\n"
+            "\nBenchmarks:\n");
+        for (const auto& benchmark : kBenchmarks)
+            ::printf("  %s\n", benchmark.Name);
+        return 0;
+    }
+
+    auto filter = options.GetString("filter", "");
+    auto minTime = options.GetUInt("min-time", 500);
+    auto list = options.GetBool("list", false);
+    auto csv = options.GetBool("csv", false);
+    options.CheckUnused();
+
+    if (list)
+    {
+        for (const auto& benchmark : kBenchmarks)
+            ::printf("%s\n", benchmark.Name);
+        return 0;
+    }
+
+    size_t nameWidth = 0;
+    for (const auto& benchmark : kBenchmarks)
+        nameWidth = std::max(nameWidth, ::strlen(benchmark.Name));
+
+    Report report(csv);
+    report.SetColumns({ "benchmark", "iterations", "ns/op", "ops/s", "p50(us)", "p99(us)", "p999(us)", "max(us)" },
+        { nameWidth });
+
+    for (const auto& benchmark : kBenchmarks)
+    {
+        if (!filter.empty() && string(benchmark.Name).find(filter) == string::npos)
+            continue;
+
+        auto state = RunBenchmark(benchmark, minTime * 1000000ull);
+        auto nanos = static_cast<double>(state.GetElapsed()) / static_cast<double>(state.GetIterations());
+
+        vector<string> row = {
+            benchmark.Name,
+            FormatUInt(state.GetIterations()),
+            FormatDouble(nanos, 1),
+            FormatDouble(1e9 / nanos, 0),
+        };
+        if (state.HasLatency())
+            AppendLatencyColumns(row, state.GetLatency());
+        else
+            row.insert(row.end(), 4, "-");
+        report.AddRow(row);
+    }
+    return 0;
+}
@@ -0,0 +1,513 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include "Bench.hpp"
+
+#include <Moe.UV/AsyncNotifier.hpp>
+#include <Moe.UV/RunLoop.hpp>
+#include <Moe.UV/TcpSocket.hpp>
+#include <Moe.UV/Timer.hpp>
+
+#include <Moe.Core/Exception.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <thread>
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+using namespace Bench;
+
+namespace
+{
+    const unsigned kMaxPendingConnects = 256;  // 每个RunLoop上同时发起的连接数，避免侦听队列溢出
+    const unsigned kListenBacklog = 4096;
+    const uint64_t kConnectionsPerPort = 16000;  // 单个目标端口上的连接数，受本地临时端口范围限制
+
+    struct EchoConfig
+    {
+        uint64_t Connections = 0;
+        uint64_t MessageSize = 0;
+        unsigned Loops = 0;
+        uint16_t BasePort = 0;
+        unsigned Ports = 0;
+        Time::Tick Warmup = 0;
+        Time::Tick Duration = 0;
+        bool NoDelay = true;
+        unsigned SpinBudget = 0;  // 非0时以RunLoop::RunBusyPoll运行
+        unsigned SocketBusyPoll = 0;  // 非0时对套接字设置SO_BUSY_POLL
+    };
+
+    void RunEchoLoop(RunLoop& loop, const EchoConfig& config)
+    {
+        if (config.SpinBudget != 0)
+            loop.RunBusyPoll(config.SpinBudget);
+        else
+            loop.Run();
+    }
+
+    struct EchoResult
+    {
+        uint64_t Connected = 0;
+        uint64_t Errors = 0;
+        uint64_t Messages = 0;
+        LatencyHistogram Latency;
+    };
+
+    /**
+     * @brief 回显服务端线程
+     *
+     * 负责侦听分配给它的端口，每个连接将读到的数据原样通过Stream::Write写回。
+     */
+    class ServerLoop :
+        public NonCopyable
+    {
+    public:
+        ~ServerLoop()
+        {
+            Stop();
+        }
+
+    public:
+        void Start(const EchoConfig& config, vector<uint16_t> ports)
+        {
+            m_stThread = thread([this, config, ports]() { ThreadMain(config, ports); });
+
+            try
+            {
+                m_pStop = m_stReady.get_future().get();
+            }
+            catch (...)
+            {
+                m_stThread.join();
+                throw;
+            }
+        }
+
+        void Stop()noexcept
+        {
+            if (!m_stThread.joinable())
+                return;
+
+            if (m_pStop)
+                m_pStop->Notify();
+            m_stThread.join();
+            m_pStop = nullptr;
+        }
+
+    private:
+        void ThreadMain(EchoConfig config, vector<uint16_t> ports)noexcept
+        {
+            bool started = false;
+            try
+            {
+                ObjectPool pool;
+                RunLoop loop(pool);
+
+                vector<unique_ptr<TcpSocket>> listeners;
+                vector<unique_ptr<TcpSocket>> connections;
+
+                for (auto port : ports)
+                {
+                    unique_ptr<TcpSocket> listener(new TcpSocket(TcpSocket::Create()));
+                    listener->Bind(EndPoint("127.0.0.1", port), false);
+                    if (config.SocketBusyPoll != 0)
+                        listener->SetBusyPoll(config.SocketBusyPoll);  // 尽早暴露权限等错误
+                    listener->Listen(kListenBacklog);
+
+                    auto lp = listener.get();
+                    lp->SetOnConnectionCallback([&, lp]() {
+                        unique_ptr<TcpSocket> connection(new TcpSocket(lp->Accept()));
+                        auto cp = connection.get();
+                        if (config.NoDelay)
+                            cp->SetNoDelay(true);
+                        if (config.SocketBusyPoll != 0)
+                            cp->SetBusyPoll(config.SocketBusyPoll);
+                        cp->SetOnDataCallback([cp](BytesView data) { cp->Write(data); });
+                        cp->SetOnEofCallback([cp]() { cp->Close(); });
+                        cp->StartRead();
+                        connections.push_back(std::move(connection));
+                    });
+                    listeners.push_back(std::move(listener));
+                }
+
+                auto stop = AsyncNotifier::Create();
+                stop.SetOnAsyncCallback([&]() {
+                    for (auto& listener : listeners)
+                        listener->Close();
+                    for (auto& connection : connections)
+                        connection->Close();
+                    stop.Close();
+                });
+
+                started = true;
+                m_stReady.set_value(&stop);
+                RunEchoLoop(loop, config);
+            }
+            catch (...)
+            {
+                if (!started)
+                    m_stReady.set_exception(current_exception());
+                else
+                    ::fprintf(stderr, "error: echo server exited unexpectedly\n");
+            }
+        }
+
+    private:
+        thread m_stThread;
+        promise<AsyncNotifier*> m_stReady;
+        AsyncNotifier* m_pStop = nullptr;
+    };
+
+    /**
+     * @brief 客户端线程
+     *
+     * 先建立全部连接，收到开始信号后每个连接循环发送一条消息并等待完整回显，记录往返延迟。
+     */
+    class ClientLoop :
+        public NonCopyable
+    {
+    public:
+        ~ClientLoop()
+        {
+            if (!m_stThread.joinable())
+                return;
+
+            // 异常退出时通知线程直接关闭所有连接
+            m_bAbort.store(true, memory_order_relaxed);
+            try
+            {
+                if (!m_pGo)
+                    WaitConnected();
+                m_pGo->Notify();
+            }
+            catch (...)
+            {
+            }
+            m_stThread.join();
+        }
+
+    public:
+        void Start(const EchoConfig& config, unsigned index)
+        {
+            m_stThread = thread([this, config, index]() { ThreadMain(config, index); });
+        }
+
+        /**
+         * @brief 等待连接阶段结束
+         */
+        void WaitConnected()
+        {
+            m_pGo = m_stReady.get_future().get();
+        }
+
+        /**
+         * @brief 开始收发
+         */
+        void Go()
+        {
+            m_pGo->Notify();
+        }
+
+        /**
+         * @brief 等待结束并获取结果
+         */
+        EchoResult Join()
+        {
+            m_stThread.join();
+            m_pGo = nullptr;
+            if (m_pError)
+                rethrow_exception(m_pError);
+            return std::move(m_stResult);
+        }
+
+    private:
+        struct Connection
+        {
+            unique_ptr<TcpSocket> Socket;
+            uint64_t Received = 0;
+            uint64_t SentAt = 0;
+        };
+
+        void ThreadMain(EchoConfig config, unsigned index)noexcept
+        {
+            bool readySet = false;
+            try
+            {
+                ObjectPool pool;
+                RunLoop loop(pool);
+
+                auto count = config.Connections / config.Loops + (index < config.Connections % config.Loops ? 1 : 0);
+                vector<uint8_t> payload(config.MessageSize, 'x');
+                vector<unique_ptr<Connection>> connections;
+                connections.reserve(count);
+
+                uint64_t next = 0, pending = 0, failed = 0;
+                uint64_t measureBegin = 0, measureEnd = 0;
+                bool finished = false;
+
+                auto go = AsyncNotifier::Create();
+                auto timer = Timer::Create();
+
+                auto send = [&](Connection* c) {
+                    c->SentAt = RunLoop::NowNanos();
+                    try
+                    {
+                        c->Socket->WriteNoCopy(BytesView(payload.data(), payload.size()), [](int) {});
+                    }
+                    catch (const ExceptionBase&)
+                    {
+                        ++m_stResult.Errors;
+                    }
+                };
+
+                auto signalReady = [&]() {
+                    if (!readySet && m_stResult.Connected + failed == count)
+                    {
+                        readySet = true;
+                        m_stReady.set_value(&go);
+                    }
+                };
+
+                function<void()> connectMore = [&]() {
+                    while (pending < kMaxPendingConnects && next < count)
+                    {
+                        auto global = index + next * config.Loops;
+                        auto port = static_cast<uint16_t>(config.BasePort + global % config.Ports);
+                        ++next;
+
+                        unique_ptr<Connection> connection(new Connection());
+                        connection->Socket.reset(new TcpSocket(TcpSocket::Create()));
+                        auto c = connection.get();
+
+                        c->Socket->SetOnConnectCallback([&, c](int status) {
+                            --pending;
+                            if (status == 0)
+                            {
+                                ++m_stResult.Connected;
+                                if (config.NoDelay)
+                                    c->Socket->SetNoDelay(true);
+                                if (config.SocketBusyPoll != 0)
+                                    c->Socket->SetBusyPoll(config.SocketBusyPoll);
+                                c->Socket->StartRead();
+                            }
+                            else
+                            {
+                                ++failed;
+                                c->Socket->Close();
+                            }
+                            connectMore();
+                            signalReady();
+                        });
+                        c->Socket->SetOnDataCallback([&, c](BytesView data) {
+                            c->Received += data.GetSize();
+                            if (c->Received < config.MessageSize)
+                                return;
+                            c->Received -= config.MessageSize;
+
+                            auto now = RunLoop::NowNanos();
+                            if (c->SentAt >= measureBegin && now <= measureEnd)
+                            {
+                                m_stResult.Latency.Record(now - c->SentAt);
+                                ++m_stResult.Messages;
+                            }
+                            if (!finished)
+                                send(c);
+                        });
+                        c->Socket->SetOnErrorCallback([&](int) { ++m_stResult.Errors; });
+                        c->Socket->SetOnEofCallback([c]() { c->Socket->Close(); });
+
+                        c->Socket->Connect(EndPoint("127.0.0.1", port));
+                        ++pending;
+                        connections.push_back(std::move(connection));
+                    }
+                };
+
+                go.SetOnAsyncCallback([&]() {
+                    go.Close();
+                    if (m_bAbort.load(memory_order_relaxed))
+                    {
+                        for (auto& c : connections)
+                            c->Socket->Close();
+                        return;
+                    }
+
+                    auto now = RunLoop::NowNanos();
+                    measureBegin = now + config.Warmup * 1000000ull;
+                    measureEnd = measureBegin + config.Duration * 1000000ull;
+                    timer.SetFirstTime(config.Warmup + config.Duration);
+                    timer.Start();
+
+                    for (auto& c : connections)
+                    {
+                        if (!c->Socket->IsClosing())
+                            send(c.get());
+                    }
+                });
+
+                timer.SetOnTimeCallback([&]() {
+                    finished = true;
+                    timer.Close();
+                    for (auto& c : connections)
+                        c->Socket->Close();
+                });
+
+                connectMore();
+                signalReady();
+                RunEchoLoop(loop, config);
+            }
+            catch (...)
+            {
+                if (!readySet)
+                    m_stReady.set_exception(current_exception());
+                else
+                    m_pError = current_exception();
+            }
+        }
+
+    private:
+        thread m_stThread;
+        promise<AsyncNotifier*> m_stReady;
+        AsyncNotifier* m_pGo = nullptr;
+        atomic<bool> m_bAbort { false };
+
+        EchoResult m_stResult;
+        exception_ptr m_pError;
+    };
+
+    EchoResult RunOnce(const EchoConfig& config)
+    {
+        vector<unique_ptr<ServerLoop>> servers;
+        for (unsigned i = 0; i < config.Loops; ++i)
+        {
+            vector<uint16_t> ports;
+            for (auto p = i; p < config.Ports; p += config.Loops)
+                ports.push_back(static_cast<uint16_t>(config.BasePort + p));
+
+            servers.emplace_back(new ServerLoop());
+            servers.back()->Start(config, std::move(ports));
+        }
+
+        vector<unique_ptr<ClientLoop>> clients;
+        for (unsigned i = 0; i < config.Loops; ++i)
+        {
+            clients.emplace_back(new ClientLoop());
+            clients.back()->Start(config, i);
+        }
+        for (auto& client : clients)
+            client->WaitConnected();
+        for (auto& client : clients)
+            client->Go();
+
+        EchoResult ret;
+        for (auto& client : clients)
+        {
+            auto result = client->Join();
+            ret.Connected += result.Connected;
+            ret.Errors += result.Errors;
+            ret.Messages += result.Messages;
+            ret.Latency.Merge(result.Latency);
+        }
+
+        for (auto& server : servers)
+            server->Stop();
+        return ret;
+    }
+}
+
+int Bench::RunTcpEchoBench(const Options& options)
+{
+    if (options.Has("help"))
+    {
+        ::printf(
+            "Options:\n"
+            "  --conns=LIST      connection counts (default 1,10,100,1000,10000,100000)\n"
+            "  --sizes=LIST      message sizes in bytes (default 64,1024,16384)\n"
+            "  --loops=LIST      RunLoop threads on each side (default 1,2,4)\n"
+            "  --warmup=MS       warmup before measuring (default 1000)\n"
+            "  --duration=MS     measuring time (default 3000)\n"
+            "  --port=N          first listening port (default 20000)\n"
+            "  --nodelay=BOOL    disable Nagle (default 1)\n"
+            "  --busy-poll=US    run loops with RunLoop::RunBusyPoll and this spin budget (default 0, off)\n"
+            "  --so-busy-poll=US set SO_BUSY_POLL on sockets (default 0, off)\n");
+        return 0;
+    }
+
+    auto conns = options.GetUIntList("conns", { 1, 10, 100, 1000, 10000, 100000 });
+    auto sizes = options.GetUIntList("sizes", { 64, 1024, 16384 });
+    auto loops = options.GetUIntList("loops", { 1, 2, 4 });
+    auto warmup = options.GetUInt("warmup", 1000);
+    auto duration = options.GetUInt("duration", 3000);
+    auto port = options.GetUInt("port", 20000);
+    auto noDelay = options.GetBool("nodelay", true);
+    auto spinBudget = options.GetUInt("busy-poll", 0);
+    auto socketBusyPoll = options.GetUInt("so-busy-poll", 0);
+    auto csv = options.GetBool("csv", false);
+    options.CheckUnused();
+
+    uint64_t maxConns = 0;
+    for (auto n : conns)
+        maxConns = std::max(maxConns, n);
+    auto fdLimit = RaiseFdLimit(maxConns * 2 + 256);
+
+    Report report(csv);
+    report.SetColumns({ "conns", "size", "loops", "connected", "msg/s", "MiB/s", "p50(us)", "p99(us)", "p999(us)",
+        "max(us)", "errors" });
+
+    for (auto n : conns)
+    {
+        for (auto size : sizes)
+        {
+            for (auto loop : loops)
+            {
+                if (n == 0 || size == 0 || loop == 0)
+                    MOE_THROW(BadArgumentException, "Connections, sizes and loops must be positive");
+                if (n * 2 + 256 > fdLimit)
+                {
+                    ::fprintf(stderr, "skip conns=%llu: file descriptor limit is %llu\n",
+                        static_cast<unsigned long long>(n), static_cast<unsigned long long>(fdLimit));
+                    continue;
+                }
+
+                EchoConfig config;
+                config.Connections = n;
+                config.MessageSize = size;
+                config.Loops = static_cast<unsigned>(loop);
+                config.Ports = static_cast<unsigned>(std::max<uint64_t>(loop, (n + kConnectionsPerPort - 1) /
+                    kConnectionsPerPort));
+                config.Warmup = warmup;
+                config.Duration = duration;
+                config.NoDelay = noDelay;
+                config.SpinBudget = static_cast<unsigned>(spinBudget);
+                config.SocketBusyPoll = static_cast<unsigned>(socketBusyPoll);
+
+                // 每轮使用新的端口，避免上一轮遗留的TIME_WAIT占满临时端口
+                if (port + config.Ports > 65535)
+                    port = options.GetUInt("port", 20000);
+                config.BasePort = static_cast<uint16_t>(port);
+                port += config.Ports;
+
+                auto result = RunOnce(config);
+                auto seconds = static_cast<double>(duration) / 1000.;
+
+                vector<string> row = {
+                    FormatUInt(n),
+                    FormatUInt(size),
+                    FormatUInt(loop),
+                    FormatUInt(result.Connected),
+                    FormatDouble(static_cast<double>(result.Messages) / seconds, 0),
+                    FormatDouble(static_cast<double>(result.Messages * size) / seconds / (1024. * 1024.)),
+                };
+                AppendLatencyColumns(row, result.Latency);
+                row.push_back(FormatUInt(result.Errors));
+                report.AddRow(row);
+            }
+        }
+    }
+    return 0;
+}
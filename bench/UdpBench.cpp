@@ -0,0 +1,442 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include "Bench.hpp"
+
+#include <Moe.UV/AsyncNotifier.hpp>
+#include <Moe.UV/EventHandle.hpp>
+#include <Moe.UV/RunLoop.hpp>
+#include <Moe.UV/Timer.hpp>
+#include <Moe.UV/UdpSocket.hpp>
+
+#include <Moe.Core/Exception.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <thread>
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+using namespace Bench;
+
+namespace
+{
+    const Time::Tick kDrainTime = 200;  // 发送结束后等待接收方收完在途数据包的时间
+
+    enum class SendMode
+    {
+        Send,
+        SendNoCopy,
+        TrySend,
+    };
+
+    struct UdpConfig
+    {
+        SendMode Mode = SendMode::Send;
+        uint64_t PacketSize = 0;
+        unsigned Sockets = 0;
+        unsigned Loops = 0;
+        uint64_t Window = 0;
+        Time::Tick Warmup = 0;
+        Time::Tick Duration = 0;
+    };
+
+    struct UdpResult
+    {
+        uint64_t Packets = 0;  // 全程收发的包数
+        uint64_t MeasuredPackets = 0;  // 测量区间内收发的包数
+        uint64_t MeasuredBytes = 0;  // 测量区间内收发的字节数
+        uint64_t Errors = 0;
+    };
+
+    /**
+     * @brief 收发线程
+     *
+     * 接收方在本地回环上绑定若干套接字；发送方的每个套接字对应一个接收套接字，
+     * 在Idle事件中以选定的发送方式持续发包，发送队列中最多保持Window个包。
+     */
+    class UdpLoop :
+        public NonCopyable
+    {
+        enum
+        {
+            kPhaseIdle,
+            kPhaseGo,
+            kPhaseStop,
+        };
+
+    public:
+        ~UdpLoop()
+        {
+            if (!m_stThread.joinable())
+                return;
+
+            try
+            {
+                if (!m_pControl)
+                    WaitReady();
+                Stop();
+            }
+            catch (...)
+            {
+            }
+            m_stThread.join();
+        }
+
+    public:
+        void Start(const UdpConfig& config, vector<EndPoint> targets)
+        {
+            m_stThread = thread([this, config, targets]() { ThreadMain(config, targets); });
+        }
+
+        /**
+         * @brief 等待套接字就绪
+         * @return 各套接字绑定的本地地址
+         */
+        vector<EndPoint> WaitReady()
+        {
+            m_pControl = m_stReady.get_future().get();
+            return std::move(m_stLocal);
+        }
+
+        /**
+         * @brief 开始收发
+         */
+        void Go()
+        {
+            m_iPhase.store(kPhaseGo, memory_order_release);
+            m_pControl->Notify();
+        }
+
+        /**
+         * @brief 关闭所有句柄
+         */
+        void Stop()
+        {
+            m_iPhase.store(kPhaseStop, memory_order_release);
+            m_pControl->Notify();
+        }
+
+        /**
+         * @brief 等待结束并获取结果
+         */
+        UdpResult Join()
+        {
+            m_stThread.join();
+            m_pControl = nullptr;
+            if (m_pError)
+                rethrow_exception(m_pError);
+            return m_stResult;
+        }
+
+    private:
+        void ThreadMain(UdpConfig config, vector<EndPoint> targets)noexcept
+        {
+            bool readySet = false;
+            try
+            {
+                ObjectPool pool;
+                RunLoop loop(pool);
+
+                auto sender = !targets.empty();
+                vector<uint8_t> payload(config.PacketSize, 'x');
+                BytesView view(payload.data(), payload.size());
+                vector<unique_ptr<UdpSocket>> sockets;
+
+                for (unsigned i = 0; i < config.Sockets; ++i)
+                {
+                    unique_ptr<UdpSocket> socket(new UdpSocket(UdpSocket::Create(EndPoint("127.0.0.1", 0), false)));
+                    socket->SetIoStatsEnabled(true);
+                    if (!sender)
+                    {
+                        socket->SetOnDataCallback([](const EndPoint&, BytesView) {});
+                        socket->StartRead();
+                        m_stLocal.push_back(socket->GetLocalEndPoint());
+                    }
+                    sockets.push_back(std::move(socket));
+                }
+
+                // 统计所有套接字上已完成的收发
+                auto count = [&](uint64_t& packets, uint64_t& bytes, uint64_t& errors) {
+                    packets = bytes = errors = 0;
+                    for (auto& socket : sockets)
+                    {
+                        auto stats = socket->GetIoStats();
+                        packets += sender ? stats->WriteOps : stats->ReadOps;
+                        bytes += sender ? stats->BytesWritten : stats->BytesRead;
+                        errors += stats->Errors;
+                    }
+                };
+
+                uint64_t beginPackets = 0, beginBytes = 0, sendErrors = 0, ignored = 0;
+                bool started = false, measuring = false, finished = false;
+
+                auto control = AsyncNotifier::Create();
+                auto timer = Timer::Create();
+                auto pump = EventHandle::Create(EventHandle::EventType::Idle);
+
+                UdpSocket::OnSendCallbackType onSent = [&](int status) {
+                    if (status != 0 && !finished)
+                        ++sendErrors;
+                };
+
+                pump.SetOnEventCallback([&]() {
+                    for (size_t i = 0; i < sockets.size(); ++i)
+                    {
+                        auto& socket = *sockets[i];
+                        auto& target = targets[i % targets.size()];
+                        if (socket.IsClosing())
+                            continue;
+
+                        try
+                        {
+                            // 可写时libuv会同步完成发送，因此除队列长度外还需限制单次突发的数量
+                            for (uint64_t j = 0; j < config.Window; ++j)
+                            {
+                                if (config.Mode == SendMode::TrySend)
+                                {
+                                    if (!socket.TrySend(target, view))
+                                        break;
+                                    continue;
+                                }
+
+                                if (socket.GetSendQueueCount() >= config.Window)
+                                    break;
+                                if (config.Mode == SendMode::Send)
+                                    socket.Send(target, view);
+                                else
+                                    socket.SendNoCopy(target, view, onSent);
+                            }
+                        }
+                        catch (const ExceptionBase&)
+                        {
+                            ++sendErrors;
+                        }
+                    }
+                });
+
+                timer.SetFirstTime(config.Warmup);
+                timer.SetInterval(config.Duration);
+                timer.SetOnTimeCallback([&]() {
+                    if (!measuring)
+                    {
+                        measuring = true;
+                        count(beginPackets, beginBytes, ignored);
+                        return;
+                    }
+
+                    uint64_t errors = 0;
+                    count(m_stResult.MeasuredPackets, m_stResult.MeasuredBytes, errors);
+                    m_stResult.MeasuredPackets -= beginPackets;
+                    m_stResult.MeasuredBytes -= beginBytes;
+                    m_stResult.Errors = errors + sendErrors;
+
+                    finished = true;
+                    timer.Close();
+                    if (sender)
+                    {
+                        pump.Close();
+                        for (auto& socket : sockets)
+                            socket->Close();
+                    }
+                });
+
+                control.SetOnAsyncCallback([&]() {
+                    auto phase = m_iPhase.load(memory_order_acquire);
+                    if (phase == kPhaseStop)
+                    {
+                        control.Close();
+                        timer.Close();
+                        pump.Close();
+                        for (auto& socket : sockets)
+                            socket->Close();
+                    }
+                    else if (phase == kPhaseGo && !started)
+                    {
+                        started = true;
+                        timer.Start();
+                        if (sender)
+                            pump.Start();
+                    }
+                });
+
+                readySet = true;
+                m_stReady.set_value(&control);
+                loop.Run();
+
+                uint64_t bytes = 0, errors = 0;
+                count(m_stResult.Packets, bytes, errors);
+                if (!finished)
+                    m_stResult.Errors = errors + sendErrors;
+            }
+            catch (...)
+            {
+                if (!readySet)
+                    m_stReady.set_exception(current_exception());
+                else
+                    m_pError = current_exception();
+            }
+        }
+
+    private:
+        thread m_stThread;
+        promise<AsyncNotifier*> m_stReady;
+        AsyncNotifier* m_pControl = nullptr;
+        atomic<int> m_iPhase { kPhaseIdle };
+
+        vector<EndPoint> m_stLocal;
+        UdpResult m_stResult;
+        exception_ptr m_pError;
+    };
+
+    struct UdpRunResult
+    {
+        UdpResult Sent;
+        UdpResult Received;
+    };
+
+    UdpRunResult RunOnce(const UdpConfig& config)
+    {
+        vector<unique_ptr<UdpLoop>> receivers;
+        vector<vector<EndPoint>> targets;
+        for (unsigned i = 0; i < config.Loops; ++i)
+        {
+            receivers.emplace_back(new UdpLoop());
+            receivers.back()->Start(config, {});
+        }
+        for (auto& receiver : receivers)
+            targets.push_back(receiver->WaitReady());
+
+        vector<unique_ptr<UdpLoop>> senders;
+        for (unsigned i = 0; i < config.Loops; ++i)
+        {
+            senders.emplace_back(new UdpLoop());
+            senders.back()->Start(config, targets[i]);
+        }
+        for (auto& sender : senders)
+            sender->WaitReady();
+
+        for (auto& receiver : receivers)
+            receiver->Go();
+        for (auto& sender : senders)
+            sender->Go();
+
+        // 发送方在测量结束后自行停止发送，接收方额外等待在途的数据包
+        this_thread::sleep_for(chrono::milliseconds(config.Warmup + config.Duration + kDrainTime));
+
+        auto collect = [](vector<unique_ptr<UdpLoop>>& loops) {
+            UdpResult ret;
+            for (auto& loop : loops)
+                loop->Stop();
+            for (auto& loop : loops)
+            {
+                auto result = loop->Join();
+                ret.Packets += result.Packets;
+                ret.MeasuredPackets += result.MeasuredPackets;
+                ret.MeasuredBytes += result.MeasuredBytes;
+                ret.Errors += result.Errors;
+            }
+            return ret;
+        };
+
+        UdpRunResult ret;
+        ret.Sent = collect(senders);
+        ret.Received = collect(receivers);
+        return ret;
+    }
+
+    SendMode ParseSendMode(const string& name)
+    {
+        if (name == "send")
+            return SendMode::Send;
+        if (name == "nocopy")
+            return SendMode::SendNoCopy;
+        if (name == "trysend")
+            return SendMode::TrySend;
+        MOE_THROW(BadArgumentException, "Unknown send mode \"{0}\"", name);
+    }
+}
+
+int Bench::RunUdpBench(const Options& options)
+{
+    if (options.Has("help"))
+    {
+        ::printf(
+            "Options:\n"
+            "  --modes=LIST      send methods: send,nocopy,trysend (default all)\n"
+            "  --sizes=LIST      packet sizes in bytes (default 64,512,1400)\n"
+            "  --sockets=LIST    sockets per RunLoop on each side (default 1,4)\n"
+            "  --loops=LIST      RunLoop threads on each side (default 1,2)\n"
+            "  --window=N        max queued sends per socket, or TrySend burst (default 64)\n"
+            "  --warmup=MS       warmup before measuring (default 500)\n"
+            "  --duration=MS     measuring time (default 2000)\n");
+        return 0;
+    }
+
+    auto modes = options.GetStringList("modes", { "send", "nocopy", "trysend" });
+    auto sizes = options.GetUIntList("sizes", { 64, 512, 1400 });
+    auto sockets = options.GetUIntList("sockets", { 1, 4 });
+    auto loops = options.GetUIntList("loops", { 1, 2 });
+    auto window = options.GetUInt("window", 64);
+    auto warmup = options.GetUInt("warmup", 500);
+    auto duration = options.GetUInt("duration", 2000);
+    auto csv = options.GetBool("csv", false);
+    options.CheckUnused();
+
+    for (const auto& mode : modes)
+        ParseSendMode(mode);
+    if (window == 0 || duration == 0)
+        MOE_THROW(BadArgumentException, "Window and duration must be positive");
+
+    Report report(csv);
+    report.SetColumns({ "mode", "size", "sockets", "loops", "tx pps", "rx pps", "rx MiB/s", "drop(%)", "errors" });
+
+    for (const auto& mode : modes)
+    {
+        for (auto size : sizes)
+        {
+            for (auto socketCount : sockets)
+            {
+                for (auto loop : loops)
+                {
+                    if (size == 0 || size > 65507 || socketCount == 0 || loop == 0)
+                        MOE_THROW(BadArgumentException, "Sizes must be in [1, 65507], sockets and loops positive");
+
+                    UdpConfig config;
+                    config.Mode = ParseSendMode(mode);
+                    config.PacketSize = size;
+                    config.Sockets = static_cast<unsigned>(socketCount);
+                    config.Loops = static_cast<unsigned>(loop);
+                    config.Window = window;
+                    config.Warmup = warmup;
+                    config.Duration = duration;
+
+                    auto result = RunOnce(config);
+                    auto seconds = static_cast<double>(duration) / 1000.;
+                    auto drop = result.Sent.Packets == 0 || result.Received.Packets >= result.Sent.Packets ? 0. :
+                        static_cast<double>(result.Sent.Packets - result.Received.Packets) * 100. /
+                        static_cast<double>(result.Sent.Packets);
+
+                    report.AddRow({
+                        mode,
+                        FormatUInt(size),
+                        FormatUInt(socketCount),
+                        FormatUInt(loop),
+                        FormatDouble(static_cast<double>(result.Sent.MeasuredPackets) / seconds, 0),
+                        FormatDouble(static_cast<double>(result.Received.MeasuredPackets) / seconds, 0),
+                        FormatDouble(static_cast<double>(result.Received.MeasuredBytes) / seconds / (1024. * 1024.)),
+                        FormatDouble(drop),
+                        FormatUInt(result.Sent.Errors + result.Received.Errors),
+                    });
+                }
+            }
+        }
+    }
+    return 0;
+}
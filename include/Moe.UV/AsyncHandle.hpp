@@ -14,6 +14,7 @@ namespace moe
 namespace UV
 {
     class RunLoop;
+    struct IoStats;
 
     /**
      * @brief 异步句柄
@@ -69,6 +70,19 @@ namespace UV
          */
         bool IsClosing()const noexcept;
 
+        /**
+         * @brief 获取句柄类型名称
+         *
+         * 如"tcp"、"udp"、"timer"等，已关闭时返回"unknown"。
+         */
+        const char* GetTypeName()const noexcept;
+
+        /**
+         * @brief 获取I/O计数
+         * @return 不支持或未启用时返回nullptr
+         */
+        virtual const IoStats* GetIoStats()const noexcept;
+
         /**
          * @brief 增加RunLoop对句柄的引用
          */
@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include <Moe.Core/StringUtils.hpp>
+
+#include "File.hpp"
+#include "Timer.hpp"
+
+#include <memory>
+
+namespace moe
+{
+namespace UV
+{
+    /**
+     * @brief 异步日志输出器
+     *
+     * - 每个RunLoop线程至多一个，日志被格式化后追加到环形缓冲区，由File在线程池中批量写出，不会阻塞RunLoop。
+     * - 缓冲区超过一半或者定时器到期时触发写出，同一时刻至多一个写请求。
+     * - 缓冲区满时直接丢弃新的日志并计数，恢复后会补写一条丢弃提示。
+     * - 析构时同步写出剩余的日志。
+     */
+    class AsyncLogAppender :
+        public NonCopyable
+    {
+    public:
+        static const size_t kDefaultBufferSize = 1024 * 1024;
+        static const Time::Tick kDefaultFlushInterval = 100;
+        static const size_t kMaxMessageLength = 4096;  // 超长的日志会被截断
+
+        /**
+         * @brief 获取当前线程上的输出器
+         */
+        static AsyncLogAppender* GetCurrent()noexcept;
+
+    public:
+        /**
+         * @brief 构造输出器
+         * @param file 输出的文件，通常以OpenAppend方式打开
+         * @param bufferSize 环形缓冲区大小
+         * @param flushInterval 定时写出间隔（毫秒）
+         *
+         * 必须在RunLoop线程上构造。
+         */
+        AsyncLogAppender(File&& file, size_t bufferSize=kDefaultBufferSize,
+            Time::Tick flushInterval=kDefaultFlushInterval);
+        ~AsyncLogAppender();
+
+        AsyncLogAppender(AsyncLogAppender&&) = delete;
+        AsyncLogAppender& operator=(AsyncLogAppender&&) = delete;
+
+    public:
+        /**
+         * @brief 获取丢弃的日志条数
+         */
+        uint64_t GetDroppedCount()const noexcept;
+
+        /**
+         * @brief 获取已经写出的字节数
+         */
+        uint64_t GetWrittenBytes()const noexcept;
+
+        /**
+         * @brief 获取缓冲区中（包括正在写出）的字节数
+         */
+        size_t GetBufferedSize()const noexcept;
+
+        /**
+         * @brief 追加一条日志
+         * @param level 日志级别
+         * @param message 消息
+         * @param length 消息长度
+         * @return 缓冲区已满被丢弃时返回false
+         */
+        bool Append(const char* level, const char* message, size_t length)noexcept;
+
+        /**
+         * @brief 格式化并追加一条日志
+         * @return 缓冲区已满或格式化失败时返回false
+         */
+        template <typename... TArgs>
+        bool Log(const char* level, const char* format, TArgs&&... args)noexcept
+        {
+            try
+            {
+                auto text = StringUtils::Format(format, std::forward<TArgs>(args)...);
+                return Append(level, text.data(), text.size());
+            }
+            catch (...)
+            {
+                CountDropped();
+                return false;
+            }
+        }
+
+        /**
+         * @brief 立即写出缓冲区
+         *
+         * 若已有写请求在进行中，则在其完成后继续。
+         */
+        void Flush()noexcept;
+
+    private:
+        struct State;
+
+        void CountDropped()noexcept;
+
+    private:
+        std::shared_ptr<State> m_pState;  // 写请求回调同样持有，保证析构后依旧有效
+        Timer m_stFlushTimer;
+    };
+}
+}
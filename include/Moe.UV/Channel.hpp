@@ -0,0 +1,305 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include "AsyncNotifier.hpp"
+
+#include <atomic>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <type_traits>
+
+namespace moe
+{
+namespace UV
+{
+    /**
+     * @brief 跨线程数据通道
+     *
+     * - 多生产者单消费者（MPSC）的无锁队列，绑定到创建时所在RunLoop的AsyncNotifier上。
+     * - 容量不为0时为有界环形队列，队列满时TrySend返回false，调用方可据此做背压处理。
+     * - 容量为0时为无界链表队列，TrySend仅在通道关闭后失败。
+     * - 生产者只在通道从空闲变为待处理时唤醒RunLoop，消费侧回调一次性收到所有待处理的数据。
+     * - 对象必须在RunLoop线程上创建和销毁，且销毁前生产者需要停止发送。
+     */
+    template <typename T>
+    class Channel :
+        public NonCopyable
+    {
+    public:
+        using OnReceiveCallbackType = std::function<void(std::vector<T>&)>;
+
+        /**
+         * @brief 默认单批次最大处理数量
+         *
+         * 防止生产速度过快时消费侧回调无法返回。
+         */
+        static const size_t kDefaultMaxBatchSize = 1024;
+
+    public:
+        /**
+         * @brief 构造通道
+         * @param capacity 容量，为0表示无界，否则向上取整到2的幂
+         */
+        explicit Channel(size_t capacity=0)
+            : m_stNotifier(AsyncNotifier::Create())
+        {
+            if (capacity > 0)
+            {
+                size_t real = 1;
+                while (real < capacity)
+                    real <<= 1;
+
+                m_pCells.reset(new Cell[real]);
+                m_uMask = real - 1;
+                for (size_t i = 0; i < real; ++i)
+                    m_pCells[i].Sequence.store(i, std::memory_order_relaxed);
+            }
+            else
+            {
+                auto stub = new Node();
+                m_pHead.store(stub, std::memory_order_relaxed);
+                m_pTail = stub;
+            }
+
+            m_stNotifier.SetOnAsyncCallback([this]() { OnAsync(); });
+        }
+
+        Channel(Channel&&) = delete;
+        Channel& operator=(Channel&&) = delete;
+
+        ~Channel()
+        {
+            m_stNotifier.Close();
+
+            while (Pop([](T&&) {})) {}
+
+            if (!m_pCells)
+            {
+                assert(m_pTail->Next.load(std::memory_order_relaxed) == nullptr);
+                delete m_pTail;
+            }
+        }
+
+    public:
+        /**
+         * @brief 是否为有界通道
+         */
+        bool IsBounded()const noexcept { return static_cast<bool>(m_pCells); }
+
+        /**
+         * @brief 获取容量
+         *
+         * 无界通道返回0。
+         */
+        size_t GetCapacity()const noexcept { return m_pCells ? m_uMask + 1 : 0; }
+
+        /**
+         * @brief 是否已关闭
+         */
+        bool IsClosed()const noexcept { return m_bClosed.load(std::memory_order_acquire); }
+
+        /**
+         * @brief 获取单批次最大处理数量
+         */
+        size_t GetMaxBatchSize()const noexcept { return m_uMaxBatchSize; }
+
+        /**
+         * @brief 设置单批次最大处理数量
+         */
+        void SetMaxBatchSize(size_t sz)noexcept { m_uMaxBatchSize = std::max<size_t>(sz, 1); }
+
+        /**
+         * @brief 尝试发送数据
+         * @param value 数据
+         * @return 若队列已满或通道关闭返回false，此时value不会被移走
+         *
+         * 方法为线程安全，不会阻塞。
+         */
+        bool TrySend(const T& value)
+        {
+            T tmp(value);
+            return TrySend(std::move(tmp));
+        }
+
+        bool TrySend(T&& value)
+        {
+            if (IsClosed())
+                return false;
+            if (!Push(std::move(value)))
+                return false;
+
+            // 仅在首次由空闲变为待处理时唤醒
+            if (!m_bPending.exchange(true, std::memory_order_acq_rel))
+                m_stNotifier.Notify();
+            return true;
+        }
+
+        /**
+         * @brief 关闭通道
+         *
+         * 关闭后TrySend总是失败，但已入队的数据仍会被投递。
+         * 只能在RunLoop线程调用。
+         */
+        void Close()noexcept
+        {
+            m_bClosed.store(true, std::memory_order_release);
+        }
+
+        /**
+         * @brief 立即在当前线程处理所有待处理数据
+         *
+         * 只能在RunLoop线程调用。
+         */
+        void Flush()
+        {
+            OnAsync();
+        }
+
+    public:
+        const OnReceiveCallbackType& GetOnReceiveCallback()const noexcept { return m_pOnReceive; }
+        void SetOnReceiveCallback(const OnReceiveCallbackType& cb) { m_pOnReceive = cb; }
+        void SetOnReceiveCallback(OnReceiveCallbackType&& cb) { m_pOnReceive = std::move(cb); }
+
+    protected:  // 事件
+        void OnReceive(std::vector<T>& batch)
+        {
+            if (m_pOnReceive)
+                m_pOnReceive(batch);
+        }
+
+    private:
+        // 有界队列单元（Vyukov bounded queue）
+        struct Cell
+        {
+            std::atomic<size_t> Sequence;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+        };
+
+        // 无界队列节点（Vyukov intrusive MPSC queue）
+        struct Node
+        {
+            std::atomic<Node*> Next;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+
+            Node()noexcept
+                : Next(nullptr) {}
+        };
+
+        bool Push(T&& value)
+        {
+            if (m_pCells)
+            {
+                Cell* cell = nullptr;
+                auto pos = m_uEnqueuePos.load(std::memory_order_relaxed);
+                while (true)
+                {
+                    cell = &m_pCells[pos & m_uMask];
+                    auto seq = cell->Sequence.load(std::memory_order_acquire);
+                    auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                    if (diff == 0)
+                    {
+                        if (m_uEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            break;
+                    }
+                    else if (diff < 0)
+                        return false;  // 队列已满
+                    else
+                        pos = m_uEnqueuePos.load(std::memory_order_relaxed);
+                }
+
+                new(&cell->Storage) T(std::move(value));
+                cell->Sequence.store(pos + 1, std::memory_order_release);
+            }
+            else
+            {
+                auto node = new Node();
+                new(&node->Storage) T(std::move(value));
+
+                auto prev = m_pHead.exchange(node, std::memory_order_acq_rel);
+                prev->Next.store(node, std::memory_order_release);
+            }
+            return true;
+        }
+
+        template <typename F>
+        bool Pop(F&& consumer)
+        {
+            if (m_pCells)
+            {
+                auto pos = m_uDequeuePos;
+                auto cell = &m_pCells[pos & m_uMask];
+                auto seq = cell->Sequence.load(std::memory_order_acquire);
+                if (seq != pos + 1)
+                    return false;
+
+                auto p = reinterpret_cast<T*>(&cell->Storage);
+                consumer(std::move(*p));
+                p->~T();
+
+                cell->Sequence.store(pos + m_uMask + 1, std::memory_order_release);
+                m_uDequeuePos = pos + 1;
+            }
+            else
+            {
+                auto tail = m_pTail;
+                auto next = tail->Next.load(std::memory_order_acquire);
+                if (!next)
+                    return false;
+
+                auto p = reinterpret_cast<T*>(&next->Storage);
+                consumer(std::move(*p));
+                p->~T();
+
+                // next成为新的哨兵节点
+                m_pTail = next;
+                delete tail;
+            }
+            return true;
+        }
+
+        void OnAsync()
+        {
+            m_bPending.exchange(false, std::memory_order_acq_rel);
+
+            m_stBatch.clear();
+
+            auto append = [this](T&& value) { m_stBatch.emplace_back(std::move(value)); };
+            while (m_stBatch.size() < m_uMaxBatchSize && Pop(append)) {}
+
+            // 单批次未处理完，需要再次唤醒
+            if (m_stBatch.size() >= m_uMaxBatchSize && !m_bPending.exchange(true, std::memory_order_acq_rel))
+                m_stNotifier.Notify();
+
+            if (!m_stBatch.empty())
+                OnReceive(m_stBatch);
+        }
+
+    private:
+        AsyncNotifier m_stNotifier;
+        OnReceiveCallbackType m_pOnReceive;
+        std::vector<T> m_stBatch;
+        size_t m_uMaxBatchSize = kDefaultMaxBatchSize;
+        std::atomic<bool> m_bClosed { false };
+        std::atomic<bool> m_bPending { false };
+
+        // 有界队列
+        std::unique_ptr<Cell[]> m_pCells;
+        size_t m_uMask = 0;
+        char m_stPadding0[64];
+        std::atomic<size_t> m_uEnqueuePos { 0 };
+        char m_stPadding1[64];
+        size_t m_uDequeuePos = 0;
+
+        // 无界队列
+        std::atomic<Node*> m_pHead { nullptr };
+        Node* m_pTail = nullptr;
+    };
+
+    template <typename T>
+    const size_t Channel<T>::kDefaultMaxBatchSize;
+}
+}
@@ -0,0 +1,106 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include "AsyncHandle.hpp"
+#include <Moe.Core/Pal.hpp>
+
+#include <functional>
+
+struct uv_poll_s;
+
+namespace moe
+{
+namespace UV
+{
+#ifdef MOE_LINUX
+    /**
+     * @brief eventfd句柄
+     *
+     * - 基于eventfd实现的轻量通知，任意线程或第三方库（如io_uring的完成通知）均可写入，由RunLoop线程接收。
+     * - 与AsyncNotifier相比，文件描述符可以直接交给外部代码，也可以跨fork/exec继承。
+     * - 多次写入在回调前会被合并，回调参数为累计的计数；信号量模式下每次回调只消耗1。
+     * - 仅Linux可用。
+     */
+    class EventFd :
+        public AsyncHandle
+    {
+    public:
+        using OnEventCallbackType = std::function<void(uint64_t)>;  // count
+
+        /**
+         * @brief 创建句柄
+         * @param semaphore 是否使用信号量模式（EFD_SEMAPHORE）
+         */
+        static EventFd Create(bool semaphore=false);
+
+    private:
+        static void OnUVEvent(::uv_poll_s* handle, int status, int events)noexcept;
+
+    protected:
+        EventFd(int fd, UniquePooledObject<::uv_handle_s>&& handle);
+
+    public:
+        EventFd(EventFd&& org)noexcept;
+        ~EventFd();
+
+        EventFd& operator=(EventFd&& rhs)noexcept;
+
+    public:
+        /**
+         * @brief 获取文件描述符
+         *
+         * 外部代码可以直接向其写入8字节的计数，所有权仍归句柄所有。
+         */
+        int GetFd()const noexcept { return m_iFd; }
+
+        /**
+         * @brief 开始接收通知
+         */
+        void Start();
+
+        /**
+         * @brief 停止接收通知
+         *
+         * 期间的写入会累计在计数中，重新Start后一并通知。
+         */
+        void Stop()noexcept;
+
+        /**
+         * @brief 发送通知
+         * @param value 累加的计数，不能为0
+         * @return 句柄已关闭或计数溢出时返回false
+         *
+         * 线程安全，但调用方需要保证句柄在调用期间没有被销毁或移动。
+         */
+        bool Notify(uint64_t value=1)const noexcept;
+
+        /**
+         * @brief 关闭句柄
+         *
+         * 会同时关闭内部的eventfd。
+         */
+        bool Close()noexcept override;
+
+    public:
+        const OnEventCallbackType& GetOnEventCallback()const noexcept { return m_pOnEvent; }
+        void SetOnEventCallback(const OnEventCallbackType& cb) { m_pOnEvent = cb; }
+        void SetOnEventCallback(OnEventCallbackType&& cb)noexcept { m_pOnEvent = std::move(cb); }
+
+    protected:  // 事件
+        void OnClose()override;
+        void OnEvent(uint64_t count);
+
+    private:
+        void CloseFd()noexcept;
+
+    private:
+        int m_iFd = -1;
+
+        OnEventCallbackType m_pOnEvent;
+    };
+#endif
+}
+}
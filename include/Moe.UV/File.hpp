@@ -0,0 +1,271 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include <Moe.Core/Utils.hpp>
+#include <Moe.Core/ArrayView.hpp>
+
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace moe
+{
+namespace UV
+{
+    /**
+     * @brief 文件状态
+     *
+     * 时间字段以毫秒为单位（Unix时间戳）。
+     */
+    struct FileStatus
+    {
+        uint64_t Device = 0;
+        uint64_t Mode = 0;
+        uint64_t LinkCount = 0;
+        uint64_t Uid = 0;
+        uint64_t Gid = 0;
+        uint64_t Inode = 0;
+        uint64_t Size = 0;
+        uint64_t BlockSize = 0;
+        uint64_t Blocks = 0;
+        uint64_t AccessTime = 0;
+        uint64_t ModifyTime = 0;
+        uint64_t ChangeTime = 0;
+        uint64_t BirthTime = 0;
+
+        bool IsRegularFile()const noexcept;
+        bool IsDirectory()const noexcept;
+        bool IsSymbolicLink()const noexcept;
+    };
+
+    /**
+     * @brief 异步文件
+     *
+     * - 基于uv_fs_*实现，所有操作在libuv线程池中执行，完成后在RunLoop线程上回调，不会阻塞RunLoop。
+     * - 读写均为定位读写，offset为负数时使用并更新文件当前位置。
+     * - 对象本身只持有文件描述符，销毁或关闭前调用方需要确保所有操作已经完成。
+     * - 对象析构时若文件未关闭，会同步关闭文件。
+     */
+    class File :
+        public NonCopyable
+    {
+    public:
+        enum OpenFlags
+        {
+            OpenRead = 1,
+            OpenWrite = 2,
+            OpenReadWrite = OpenRead | OpenWrite,
+            OpenCreate = 4,
+            OpenTruncate = 8,
+            OpenAppend = 16,
+            OpenExclusive = 32,
+        };
+
+        using OnOpenCallbackType = std::function<void(int, File&&)>;
+        using OnReadCallbackType = std::function<void(int, size_t)>;  // (status, bytes), bytes为0表示EOF
+        using OnWriteCallbackType = std::function<void(int, size_t)>;  // (status, bytes)
+        using OnCompleteCallbackType = std::function<void(int)>;
+        using OnStatCallbackType = std::function<void(int, const FileStatus&)>;
+
+        /**
+         * @brief 打开文件
+         * @param path 路径
+         * @param flags 打开方式，参见OpenFlags
+         * @param mode 创建文件时使用的权限
+         * @param cb 回调函数
+         *
+         * 必须有RunLoop才能调用。
+         */
+        static void Open(const char* path, int flags, int mode, const OnOpenCallbackType& cb);
+        static void Open(const char* path, int flags, int mode, OnOpenCallbackType&& cb);
+
+    public:
+        File()noexcept = default;
+        explicit File(int fd)noexcept;
+        File(File&& org)noexcept;
+        ~File();
+
+        File& operator=(File&& rhs)noexcept;
+
+        operator bool()const noexcept { return m_iFd >= 0; }
+
+    public:
+        /**
+         * @brief 获取文件描述符
+         */
+        int GetFd()const noexcept { return m_iFd; }
+
+        /**
+         * @brief 读取数据
+         * @param offset 偏移量，负数表示从当前位置读取
+         * @param buffer 缓冲区，在回调前必须保持有效
+         * @param cb 回调函数
+         */
+        void Read(int64_t offset, MutableBytesView buffer, const OnReadCallbackType& cb);
+        void Read(int64_t offset, MutableBytesView buffer, OnReadCallbackType&& cb);
+
+        /**
+         * @brief 分散读取数据
+         * @param offset 偏移量，负数表示从当前位置读取
+         * @param buffers 缓冲区列表，各缓冲区在回调前必须保持有效
+         * @param cb 回调函数
+         */
+        void Read(int64_t offset, const std::vector<MutableBytesView>& buffers, const OnReadCallbackType& cb);
+        void Read(int64_t offset, const std::vector<MutableBytesView>& buffers, OnReadCallbackType&& cb);
+
+        /**
+         * @brief 写入数据
+         * @param offset 偏移量，负数表示写入到当前位置
+         * @param buffer 数据，会被复制
+         * @param cb 回调函数
+         */
+        void Write(int64_t offset, BytesView buffer, const OnWriteCallbackType& cb=nullptr);
+        void Write(int64_t offset, BytesView buffer, OnWriteCallbackType&& cb);
+
+        /**
+         * @brief 聚集写入数据
+         * @param offset 偏移量，负数表示写入到当前位置
+         * @param buffers 数据列表，会被复制到一块连续的缓冲区中
+         * @param cb 回调函数
+         */
+        void Write(int64_t offset, const std::vector<BytesView>& buffers, const OnWriteCallbackType& cb=nullptr);
+        void Write(int64_t offset, const std::vector<BytesView>& buffers, OnWriteCallbackType&& cb);
+
+        /**
+         * @brief 写入数据（无拷贝）
+         * @param offset 偏移量，负数表示写入到当前位置
+         * @param buffer 数据，在回调前必须保持有效
+         * @param cb 回调函数
+         */
+        void WriteNoCopy(int64_t offset, BytesView buffer, const OnWriteCallbackType& cb);
+        void WriteNoCopy(int64_t offset, BytesView buffer, OnWriteCallbackType&& cb);
+
+        /**
+         * @brief 聚集写入数据（无拷贝）
+         * @param offset 偏移量，负数表示写入到当前位置
+         * @param buffers 数据列表，各数据在回调前必须保持有效
+         * @param cb 回调函数
+         */
+        void WriteNoCopy(int64_t offset, const std::vector<BytesView>& buffers, const OnWriteCallbackType& cb);
+        void WriteNoCopy(int64_t offset, const std::vector<BytesView>& buffers, OnWriteCallbackType&& cb);
+
+        /**
+         * @brief 将数据和元数据刷到磁盘
+         */
+        void Sync(const OnCompleteCallbackType& cb);
+        void Sync(OnCompleteCallbackType&& cb);
+
+        /**
+         * @brief 将数据刷到磁盘
+         *
+         * 与Sync相比不保证刷新非必要的元数据。
+         */
+        void DataSync(const OnCompleteCallbackType& cb);
+        void DataSync(OnCompleteCallbackType&& cb);
+
+        /**
+         * @brief 截断文件
+         * @param size 新的文件大小
+         * @param cb 回调函数
+         */
+        void Truncate(uint64_t size, const OnCompleteCallbackType& cb);
+        void Truncate(uint64_t size, OnCompleteCallbackType&& cb);
+
+        /**
+         * @brief 获取文件状态
+         */
+        void Stat(const OnStatCallbackType& cb);
+        void Stat(OnStatCallbackType&& cb);
+
+        /**
+         * @brief 异步关闭文件
+         *
+         * 调用后对象立即变为无效状态。
+         */
+        void Close(const OnCompleteCallbackType& cb=nullptr);
+        void Close(OnCompleteCallbackType&& cb);
+
+    private:
+        int GetFdChecked()const;
+
+    private:
+        int m_iFd = -1;
+    };
+
+    /**
+     * @brief 异步文件系统操作
+     *
+     * 必须有RunLoop才能调用。
+     */
+    class FileSystem
+    {
+    public:
+        /**
+         * @brief 扫描结果
+         */
+        struct ScanEntry
+        {
+            std::string Path;
+            FileStatus Status;  // lstat的结果，不跟随符号链接
+        };
+
+        using OnCompleteCallbackType = File::OnCompleteCallbackType;
+        using OnStatCallbackType = File::OnStatCallbackType;
+        using OnScanFilterCallbackType = std::function<bool(const std::string&, bool)>;  // (path, isDirectory)
+        using OnScanBatchCallbackType = std::function<void(std::vector<ScanEntry>&)>;
+
+        static const size_t kDefaultScanConcurrency = 4;
+        static const size_t kScanBatchSize = 1024;
+
+        /**
+         * @brief 并行扫描目录树
+         * @param root 根目录
+         * @param filter 过滤器，返回false的条目会被跳过，目录被跳过时不再深入，可以为空
+         * @param onBatch 批量结果回调，每批至多约kScanBatchSize条
+         * @param onComplete 完成回调，参数为扫描过程中遇到的第一个错误
+         * @param concurrency 同时进行扫描的目录数上限
+         *
+         * - 每个目录的readdir和其中所有条目的lstat作为一个任务在ThreadPool中完成，多个目录并行扫描。
+         * - filter在工作线程上调用，必须是线程安全的。
+         * - 单个子目录出错不会中断扫描，符号链接不会被跟随。
+         */
+        static void Scan(const char* root, const OnScanFilterCallbackType& filter, const OnScanBatchCallbackType& onBatch,
+            const OnCompleteCallbackType& onComplete, size_t concurrency=kDefaultScanConcurrency);
+
+        /**
+         * @brief 获取文件状态
+         * @param path 路径
+         * @param cb 回调函数
+         */
+        static void Stat(const char* path, const OnStatCallbackType& cb);
+        static void Stat(const char* path, OnStatCallbackType&& cb);
+
+        /**
+         * @brief 删除文件
+         */
+        static void Unlink(const char* path, const OnCompleteCallbackType& cb);
+        static void Unlink(const char* path, OnCompleteCallbackType&& cb);
+
+        /**
+         * @brief 重命名文件或目录
+         */
+        static void Rename(const char* path, const char* newPath, const OnCompleteCallbackType& cb);
+        static void Rename(const char* path, const char* newPath, OnCompleteCallbackType&& cb);
+
+        /**
+         * @brief 创建目录
+         */
+        static void MakeDir(const char* path, int mode, const OnCompleteCallbackType& cb);
+        static void MakeDir(const char* path, int mode, OnCompleteCallbackType&& cb);
+
+        /**
+         * @brief 删除空目录
+         */
+        static void RemoveDir(const char* path, const OnCompleteCallbackType& cb);
+        static void RemoveDir(const char* path, OnCompleteCallbackType&& cb);
+    };
+}
+}
@@ -45,6 +45,16 @@ namespace UV
          */
         void Start(const char* path, unsigned int flags=0);
 
+        /**
+         * @brief 激活句柄
+         * @param path 被监控文件
+         * @param flags 标志位
+         * @return 错误码，成功时返回0
+         *
+         * 与Start相同，但失败时不抛出异常，便于调用方区分具体的错误（例如监控数量达到上限）。
+         */
+        int TryStart(const char* path, unsigned int flags=0)noexcept;
+
         /**
          * @brief 终止句柄
          */
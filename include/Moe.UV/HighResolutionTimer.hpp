@@ -0,0 +1,130 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include "AsyncHandle.hpp"
+#include <Moe.Core/Pal.hpp>
+
+#include <functional>
+
+struct uv_poll_s;
+
+namespace moe
+{
+namespace UV
+{
+#ifdef MOE_LINUX
+    /**
+     * @brief 高精度计时器
+     *
+     * - 基于timerfd实现，通过uv_poll_t接入RunLoop，时间单位为纳秒。
+     * - 与Timer不同，计时不受RunLoop缓存的毫秒级时间影响，适用于发包节奏控制等亚毫秒级场景。
+     * - 绝对时间与RunLoop::NowNanos()使用同一时钟源（CLOCK_MONOTONIC）。
+     * - 仅Linux可用。
+     */
+    class HighResolutionTimer :
+        public AsyncHandle
+    {
+    public:
+        using OnTimeCallbackType = std::function<void()>;
+
+        static HighResolutionTimer Create();
+        static HighResolutionTimer CreateTickTimer(uint64_t intervalNs);
+
+    private:
+        static void OnUVEvent(::uv_poll_s* handle, int status, int events)noexcept;
+
+    protected:
+        HighResolutionTimer(int fd, UniquePooledObject<::uv_handle_s>&& handle);
+
+    public:
+        HighResolutionTimer(HighResolutionTimer&& org)noexcept;
+        ~HighResolutionTimer();
+
+        HighResolutionTimer& operator=(HighResolutionTimer&& rhs)noexcept;
+
+    public:
+        /**
+         * @brief 获取首次激活时间（纳秒）
+         */
+        uint64_t GetFirstTime()const noexcept { return m_ullFirstTime; }
+
+        /**
+         * @brief 获取时间间隔（纳秒）
+         */
+        uint64_t GetInterval()const noexcept { return m_ullInterval; }
+
+        /**
+         * @brief 获取上一次触发时累计的超时次数
+         *
+         * 当回调处理不及时时，该值可能大于1。
+         */
+        uint64_t GetLastExpirations()const noexcept { return m_ullLastExpirations; }
+
+        /**
+         * @brief 设置首次激活时间（纳秒）
+         * @param t 时间
+         */
+        void SetFirstTime(uint64_t t)noexcept { m_ullFirstTime = t; }
+
+        /**
+         * @brief 设置计时间隔（纳秒）
+         *
+         * 为0时表示单次计时器。
+         * 如果需要在计时器执行时调整间隔，需要重新Start。
+         */
+        void SetInterval(uint64_t interval)noexcept { m_ullInterval = interval; }
+
+        /**
+         * @brief 启动定时器
+         * @return 如果句柄被关闭则返回false
+         *
+         * 首次激活时间为0时将尽快触发。
+         */
+        bool Start();
+
+        /**
+         * @brief 在绝对时间点启动定时器
+         * @param deadline 绝对时间（纳秒），参见RunLoop::NowNanos()
+         * @return 如果句柄被关闭则返回false
+         */
+        bool StartAt(uint64_t deadline);
+
+        /**
+         * @brief 终止定时器
+         */
+        void Stop()noexcept;
+
+        /**
+         * @brief 关闭句柄
+         *
+         * 会同时关闭内部的timerfd。
+         */
+        bool Close()noexcept override;
+
+    public:
+        OnTimeCallbackType GetOnTimeCallback()const noexcept { return m_stOnTime; }
+        void SetOnTimeCallback(const OnTimeCallbackType& cb) { m_stOnTime = cb; }
+        void SetOnTimeCallback(OnTimeCallbackType&& cb) { m_stOnTime = std::move(cb); }
+
+    protected:  // 事件
+        void OnClose()override;
+        void OnTime();
+
+    private:
+        void Arm(uint64_t first, uint64_t interval, bool absolute);
+        void CloseFd()noexcept;
+
+    private:
+        int m_iFd = -1;
+        uint64_t m_ullFirstTime = 0;
+        uint64_t m_ullInterval = 0;
+        uint64_t m_ullLastExpirations = 0;
+
+        OnTimeCallbackType m_stOnTime;
+    };
+#endif
+}
+}
@@ -0,0 +1,32 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include <Moe.Core/Time.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace moe
+{
+namespace UV
+{
+    /**
+     * @brief 句柄的I/O计数
+     *
+     * 由Stream和UdpSocket在启用后维护，字节数与操作数均只统计成功完成的部分。
+     */
+    struct IoStats
+    {
+        Time::Tick StartTime = 0;  // 开始统计的时间（参见RunLoop::Now），可用于计算连接存活时间
+        uint64_t BytesRead = 0;  // 读到的字节数
+        uint64_t ReadOps = 0;  // 读回调次数
+        uint64_t BytesWritten = 0;  // 写出的字节数
+        uint64_t WriteOps = 0;  // 完成的写操作次数
+        size_t WriteQueueHighWater = 0;  // 写队列（UdpSocket为发送队列）的最大字节数
+        uint64_t Errors = 0;  // 触发OnError的次数
+    };
+}
+}
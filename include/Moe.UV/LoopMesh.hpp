@@ -0,0 +1,325 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include "AsyncNotifier.hpp"
+#include "EventHandle.hpp"
+
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <type_traits>
+
+namespace moe
+{
+namespace UV
+{
+    /**
+     * @brief RunLoop间的消息网格
+     *
+     * - 适用于每个线程各持有一个RunLoop的部署方式，用于在RunLoop之间转发消息或连接。
+     * - 任意两个RunLoop之间各有一条单生产者单消费者（SPSC）的有界环形队列，收发均无锁且不分配内存。
+     * - 发送方在本次迭代结束前（Prepare阶段）统一唤醒目标RunLoop，每个目标每次迭代至多唤醒一次。
+     * - 网格对象需要比所有节点存活更久，节点需在所有RunLoop停止向其发送后才能销毁。
+     */
+    template <typename T>
+    class LoopMesh :
+        public NonCopyable
+    {
+    public:
+        using OnMessageCallbackType = std::function<void(size_t, T&)>;  // (from, message)
+
+        /**
+         * @brief 网格节点
+         *
+         * 代表一个RunLoop在网格中的端点，只能在所属RunLoop线程上使用。
+         */
+        class Node :
+            public NonCopyable
+        {
+            friend class LoopMesh;
+
+        private:
+            Node(LoopMesh& mesh, size_t index)
+                : m_stMesh(mesh), m_uIndex(index), m_stNotifier(AsyncNotifier::Create()),
+                m_stPrepare(EventHandle::Create(EventHandle::EventType::Prepare))
+            {
+                m_stDirtyFlags.resize(mesh.GetSize(), 0);
+                m_stDirtyList.reserve(mesh.GetSize());
+
+                m_stNotifier.SetOnAsyncCallback([this]() { OnAsync(); });
+                m_stPrepare.SetOnEventCallback([this]() { Flush(); });
+                m_stPrepare.Start();
+                m_stPrepare.Unref();
+            }
+
+        public:
+            Node(Node&&) = delete;
+            Node& operator=(Node&&) = delete;
+
+            ~Node()
+            {
+                m_stMesh.m_pSlots[m_uIndex].Owner.store(nullptr, std::memory_order_release);
+            }
+
+        public:
+            /**
+             * @brief 获取节点序号
+             */
+            size_t GetIndex()const noexcept { return m_uIndex; }
+
+            /**
+             * @brief 尝试向目标节点发送消息
+             * @param to 目标节点序号
+             * @param message 消息
+             * @return 若对应队列已满返回false，此时消息不会被移走
+             *
+             * 实际的唤醒操作会推迟到本次迭代的Prepare阶段或者手动调用Flush时。
+             */
+            bool TrySend(size_t to, T&& message)
+            {
+                assert(to < m_stMesh.GetSize());
+
+                auto& ring = m_stMesh.GetRing(m_uIndex, to);
+                if (!ring.Push(std::move(message)))
+                    return false;
+
+                if (!m_stDirtyFlags[to])
+                {
+                    m_stDirtyFlags[to] = 1;
+                    m_stDirtyList.push_back(to);
+                }
+                return true;
+            }
+
+            bool TrySend(size_t to, const T& message)
+            {
+                T tmp(message);
+                return TrySend(to, std::move(tmp));
+            }
+
+            /**
+             * @brief 立即唤醒所有有待处理消息的目标节点
+             */
+            void Flush()
+            {
+                for (auto to : m_stDirtyList)
+                {
+                    m_stDirtyFlags[to] = 0;
+
+                    auto& slot = m_stMesh.m_pSlots[to];
+                    if (slot.Pending.exchange(true, std::memory_order_acq_rel))
+                        continue;  // 其他节点已经唤醒过
+
+                    auto node = slot.Owner.load(std::memory_order_acquire);
+                    if (node)
+                        node->m_stNotifier.Notify();
+                    else
+                        slot.Pending.store(false, std::memory_order_release);  // 节点挂载时会主动处理
+                }
+                m_stDirtyList.clear();
+            }
+
+        public:
+            const OnMessageCallbackType& GetOnMessageCallback()const noexcept { return m_pOnMessage; }
+            void SetOnMessageCallback(const OnMessageCallbackType& cb) { m_pOnMessage = cb; }
+            void SetOnMessageCallback(OnMessageCallbackType&& cb) { m_pOnMessage = std::move(cb); }
+
+        protected:  // 事件
+            void OnMessage(size_t from, T& message)
+            {
+                if (m_pOnMessage)
+                    m_pOnMessage(from, message);
+            }
+
+        private:
+            void OnAsync()
+            {
+                m_stMesh.m_pSlots[m_uIndex].Pending.exchange(false, std::memory_order_acq_rel);
+
+                bool more = false;
+                for (size_t from = 0; from < m_stMesh.GetSize(); ++from)
+                {
+                    auto& ring = m_stMesh.GetRing(from, m_uIndex);
+
+                    // 单次至多处理一个队列容量的消息，避免发送方过快导致饥饿
+                    size_t count = 0;
+                    auto deliver = [this, from](T& message) { OnMessage(from, message); };
+                    while (count < ring.GetCapacity() && ring.Pop(deliver))
+                        ++count;
+                    if (count == ring.GetCapacity() && !ring.IsEmpty())
+                        more = true;
+                }
+
+                if (more && !m_stMesh.m_pSlots[m_uIndex].Pending.exchange(true, std::memory_order_acq_rel))
+                    m_stNotifier.Notify();
+            }
+
+        private:
+            LoopMesh& m_stMesh;
+            size_t m_uIndex;
+            AsyncNotifier m_stNotifier;
+            EventHandle m_stPrepare;
+            OnMessageCallbackType m_pOnMessage;
+
+            std::vector<uint8_t> m_stDirtyFlags;
+            std::vector<size_t> m_stDirtyList;
+        };
+
+    public:
+        /**
+         * @brief 构造网格
+         * @param size 节点数量
+         * @param capacity 每条队列的容量，向上取整到2的幂
+         *
+         * 所有队列的内存在构造时一次性分配。
+         */
+        LoopMesh(size_t size, size_t capacity)
+            : m_uSize(size)
+        {
+            if (size == 0 || capacity == 0)
+                MOE_THROW(BadArgumentException, "Size and capacity must be positive");
+
+            m_pSlots.reset(new Slot[size]);
+            m_pRings.reset(new Ring[size * size]);
+            for (size_t i = 0; i < size * size; ++i)
+                m_pRings[i].Init(capacity);
+        }
+
+        LoopMesh(LoopMesh&&) = delete;
+        LoopMesh& operator=(LoopMesh&&) = delete;
+
+    public:
+        /**
+         * @brief 获取节点数量
+         */
+        size_t GetSize()const noexcept { return m_uSize; }
+
+        /**
+         * @brief 将当前RunLoop挂载为指定节点
+         * @param index 节点序号
+         * @return 节点对象
+         *
+         * 必须在节点所属的RunLoop线程上调用。挂载时会立即处理已经投递到该节点的消息。
+         */
+        std::unique_ptr<Node> Attach(size_t index)
+        {
+            if (index >= m_uSize)
+                MOE_THROW(BadArgumentException, "Index out of range");
+
+            if (m_pSlots[index].Owner.load(std::memory_order_acquire))
+                MOE_THROW(InvalidCallException, "Node is already attached");
+
+            std::unique_ptr<Node> ret(new Node(*this, index));
+            m_pSlots[index].Owner.store(ret.get(), std::memory_order_release);
+
+            m_pSlots[index].Pending.store(true, std::memory_order_release);
+            ret->m_stNotifier.Notify();
+            return ret;
+        }
+
+    private:
+        struct Ring
+        {
+            using StorageType = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+            std::unique_ptr<StorageType[]> Storage;
+            size_t Mask = 0;
+
+            char Padding0[64];
+            std::atomic<size_t> Head { 0 };  // 消费者
+            size_t CachedTail = 0;
+
+            char Padding1[64];
+            std::atomic<size_t> Tail { 0 };  // 生产者
+            size_t CachedHead = 0;
+
+            ~Ring()
+            {
+                while (Pop([](T&) {})) {}
+            }
+
+            void Init(size_t capacity)
+            {
+                size_t real = 1;
+                while (real < capacity)
+                    real <<= 1;
+                Storage.reset(new StorageType[real]);
+                Mask = real - 1;
+            }
+
+            size_t GetCapacity()const noexcept { return Mask + 1; }
+
+            bool IsEmpty()const noexcept
+            {
+                return Head.load(std::memory_order_relaxed) == Tail.load(std::memory_order_acquire);
+            }
+
+            bool Push(T&& value)
+            {
+                auto tail = Tail.load(std::memory_order_relaxed);
+                if (tail - CachedHead > Mask)
+                {
+                    CachedHead = Head.load(std::memory_order_acquire);
+                    if (tail - CachedHead > Mask)
+                        return false;
+                }
+
+                new(&Storage[tail & Mask]) T(std::move(value));
+                Tail.store(tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            template <typename F>
+            bool Pop(F&& consumer)
+            {
+                auto head = Head.load(std::memory_order_relaxed);
+                if (head == CachedTail)
+                {
+                    CachedTail = Tail.load(std::memory_order_acquire);
+                    if (head == CachedTail)
+                        return false;
+                }
+
+                auto p = reinterpret_cast<T*>(&Storage[head & Mask]);
+
+                // 确保回调抛出异常时队列状态依旧正确
+                struct Guard
+                {
+                    T* Object;
+                    std::atomic<size_t>& Head;
+                    size_t Next;
+
+                    ~Guard()
+                    {
+                        Object->~T();
+                        Head.store(Next, std::memory_order_release);
+                    }
+                } guard { p, Head, head + 1 };
+
+                consumer(*p);
+                return true;
+            }
+        };
+
+        struct Slot
+        {
+            std::atomic<Node*> Owner { nullptr };
+            std::atomic<bool> Pending { false };
+            char Padding[64];
+        };
+
+        Ring& GetRing(size_t from, size_t to)noexcept
+        {
+            return m_pRings[from * m_uSize + to];
+        }
+
+    private:
+        size_t m_uSize = 0;
+        std::unique_ptr<Slot[]> m_pSlots;
+        std::unique_ptr<Ring[]> m_pRings;
+    };
+}
+}
@@ -0,0 +1,119 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include "RunLoop.hpp"
+#include <Moe.Core/Pal.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef MOE_LINUX
+#include <pthread.h>
+#endif
+
+namespace moe
+{
+namespace UV
+{
+    /**
+     * @brief RunLoop卡顿看门狗
+     *
+     * - 启用RunLoop的活动记录，由独立线程定期检查RunLoop离开轮询（开始执行回调）的时间。
+     * - 单次迭代的执行时间超过阈值时触发一次OnStall，等待事件时的空闲不计入。
+     * - 报告中包含正在执行的回调（由MOE_UV_CATCH_ALL_BEGIN记录的函数签名，其中包含句柄类型）。
+     * - Linux下可选地通过信号中断RunLoop线程并获取其调用栈。
+     * - 必须在RunLoop线程上创建和销毁，OnStall在看门狗线程上调用。
+     */
+    class LoopWatchdog :
+        public NonCopyable
+    {
+    public:
+        struct StallInfo
+        {
+            uint64_t Duration = 0;  // 检测时已经持续的时间（毫秒）
+            const char* Callback = nullptr;  // 正在执行的回调，可能为nullptr
+            std::vector<std::string> Stack;  // RunLoop线程的调用栈，未启用或获取失败时为空
+        };
+
+        using OnStallCallbackType = std::function<void(const StallInfo&)>;
+
+        /**
+         * @brief 默认卡顿阈值（毫秒）
+         */
+        static const Time::Tick kDefaultThreshold = 200;
+
+        /**
+         * @brief 等待信号处理函数获取调用栈的最长时间（毫秒）
+         */
+        static const Time::Tick kStackCaptureTimeout = 100;
+
+    public:
+        /**
+         * @brief 在当前RunLoop上启动看门狗
+         * @param threshold 卡顿阈值（毫秒）
+         * @param stackCaptureSignal 用于获取调用栈的信号，为0时不获取，仅Linux有效
+         *
+         * 信号处理函数会被替换且不会恢复，应选择程序中未使用的信号（如SIGRTMIN+n）。
+         */
+        explicit LoopWatchdog(Time::Tick threshold=kDefaultThreshold, int stackCaptureSignal=0);
+        ~LoopWatchdog();
+
+        LoopWatchdog(LoopWatchdog&&) = delete;
+        LoopWatchdog& operator=(LoopWatchdog&&) = delete;
+
+    public:
+        /**
+         * @brief 获取卡顿阈值（毫秒）
+         */
+        Time::Tick GetThreshold()const noexcept { return m_ullThreshold; }
+
+        /**
+         * @brief 获取已检测到的卡顿次数
+         *
+         * 线程安全。
+         */
+        uint64_t GetStallCount()const noexcept { return m_ullStallCount.load(std::memory_order_relaxed); }
+
+    public:
+        /**
+         * @brief 设置卡顿回调
+         *
+         * 回调在看门狗线程上执行，不能访问RunLoop上的对象。
+         * 未设置时输出错误日志。
+         */
+        void SetOnStallCallback(const OnStallCallbackType& cb);
+        void SetOnStallCallback(OnStallCallbackType&& cb);
+
+    protected:  // 事件
+        void OnStall(const StallInfo& info);
+
+    private:
+        void ThreadMain()noexcept;
+        void CaptureStack(std::vector<std::string>& out)noexcept;
+
+    private:
+        RunLoop* m_pLoop = nullptr;
+        Time::Tick m_ullThreshold = 0;
+        int m_iSignal = 0;
+#ifdef MOE_LINUX
+        ::pthread_t m_stLoopThread;
+#endif
+
+        std::atomic<uint64_t> m_ullStallCount;
+
+        std::mutex m_stMutex;
+        std::condition_variable m_stCondVar;
+        bool m_bStopping = false;
+        OnStallCallbackType m_pOnStall;  // 由m_stMutex保护
+        std::thread m_stThread;
+    };
+}
+}
@@ -0,0 +1,205 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include <Moe.Core/ArrayView.hpp>
+
+#include "FsEvent.hpp"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+
+namespace moe
+{
+namespace UV
+{
+    /**
+     * @brief 只读映射的文件内容
+     *
+     * - 在POSIX平台上通过mmap映射整个文件，其他平台上读入内存。
+     * - 对象销毁时解除映射，因此只要持有引用，GetView返回的数据就一直有效。
+     * - 映射期间若文件被原地截断，访问会触发SIGBUS，文件应当通过rename原子替换。
+     */
+    class MappedFile :
+        public NonCopyable
+    {
+    public:
+        /**
+         * @brief 同步打开并映射文件
+         * @param path 路径
+         * @param[out] out 映射结果
+         * @return 错误码，成功时返回0
+         *
+         * 可以在任意线程上调用。
+         */
+        static int Open(const char* path, std::shared_ptr<MappedFile>& out)noexcept;
+
+    private:
+        MappedFile(void* data, size_t size, bool mapped)noexcept
+            : m_pData(data), m_uSize(size), m_bMapped(mapped) {}
+
+    public:
+        ~MappedFile();
+
+    public:
+        /**
+         * @brief 获取文件内容
+         */
+        BytesView GetView()const noexcept { return BytesView(static_cast<const uint8_t*>(m_pData), m_uSize); }
+
+        /**
+         * @brief 获取文件大小
+         */
+        size_t GetSize()const noexcept { return m_uSize; }
+
+    private:
+        void* m_pData = nullptr;
+        size_t m_uSize = 0;
+        bool m_bMapped = false;
+    };
+
+    /**
+     * @brief 映射文件缓存
+     *
+     * - 以路径为键缓存MappedFile，命中时不产生任何系统调用，内容可直接交给Stream::WriteNoCopy发送。
+     * - 通过FsEvent监控文件所在目录，文件发生变化后对应条目立即失效，已经取出的内容不受影响。
+     * - 总大小超过上限时按最近最少使用淘汰，超过上限的单个文件不会被缓存。
+     * - 目录下不再有缓存条目和进行中的加载时释放该目录的监控。
+     * - 只能在构造时所在的RunLoop线程上使用。
+     *
+     * 典型用法：
+     * @code
+     *   auto content = cache.Find(path);
+     *   if (content)
+     *       stream.WriteNoCopy(content->GetView(), [content](int) {});
+     *   else
+     *       cache.Load(path, ...);
+     * @endcode
+     */
+    class MappedFileCache :
+        public NonCopyable
+    {
+    public:
+        using ContentPtr = std::shared_ptr<const MappedFile>;
+        using OnLoadCallbackType = std::function<void(int, const ContentPtr&)>;  // (status, content)
+
+        static const size_t kDefaultMaxBytes = 256 * 1024 * 1024;
+
+    public:
+        /**
+         * @brief 构造缓存
+         * @param maxBytes 缓存内容的总大小上限
+         */
+        explicit MappedFileCache(size_t maxBytes=kDefaultMaxBytes);
+        ~MappedFileCache();
+
+        MappedFileCache(MappedFileCache&&) = delete;
+        MappedFileCache& operator=(MappedFileCache&&) = delete;
+
+    public:
+        /**
+         * @brief 获取缓存条目数
+         */
+        size_t GetCount()const noexcept { return m_stEntries.size(); }
+
+        /**
+         * @brief 获取缓存内容的总大小
+         */
+        size_t GetTotalBytes()const noexcept { return m_uTotalBytes; }
+
+        /**
+         * @brief 获取命中次数
+         */
+        uint64_t GetHitCount()const noexcept { return m_ullHitCount; }
+
+        /**
+         * @brief 获取未命中次数
+         */
+        uint64_t GetMissCount()const noexcept { return m_ullMissCount; }
+
+        /**
+         * @brief 查找缓存
+         * @param path 路径
+         * @return 未命中时返回nullptr
+         */
+        ContentPtr Find(const std::string& path)noexcept;
+
+        /**
+         * @brief 异步加载文件并放入缓存
+         * @param path 路径
+         * @param cb 回调
+         *
+         * 打开和映射在线程池中完成，同一路径上并发的加载会被合并。
+         * 无法监控所在目录时（如目录不存在）不会读取文件，以对应的错误码回调。
+         * 缓存销毁后尚未完成的加载不会再回调。
+         */
+        void Load(const std::string& path, const OnLoadCallbackType& cb);
+        void Load(const std::string& path, OnLoadCallbackType&& cb);
+
+        /**
+         * @brief 使指定路径失效
+         */
+        void Invalidate(const std::string& path)noexcept;
+
+        /**
+         * @brief 清空缓存
+         *
+         * 进行中的加载完成后不会放入缓存，其余目录监控随之释放。
+         */
+        void Clear()noexcept;
+
+    private:
+        struct DirectoryWatcher
+        {
+            FsEvent Handle;
+            size_t Refs = 0;  // 引用该目录的缓存条目及进行中的加载数量，归零时关闭
+
+            explicit DirectoryWatcher(FsEvent&& handle)noexcept
+                : Handle(std::move(handle)) {}
+        };
+
+        struct Entry
+        {
+            ContentPtr Content;
+            std::list<std::string>::iterator LruIterator;
+            DirectoryWatcher* Watcher = nullptr;
+        };
+
+        struct PendingLoad
+        {
+            bool Stale = false;  // 加载期间文件发生了变化
+            DirectoryWatcher* Watcher = nullptr;  // 监控失败时为nullptr
+            std::vector<OnLoadCallbackType> Callbacks;
+        };
+
+        static size_t GetDirectoryPrefixLength(const std::string& path)noexcept;
+
+        int Watch(const std::string& path, DirectoryWatcher*& out);
+        void Unwatch(DirectoryWatcher* watcher)noexcept;
+        void PurgeWatchers()noexcept;
+        void OnDirectoryEvent(const std::string& prefix, const char* filename, int status)noexcept;
+        void OnLoaded(const std::string& path, int status, const std::shared_ptr<MappedFile>& content)noexcept;
+        void Insert(const std::string& path, const ContentPtr& content, DirectoryWatcher* watcher);
+        void Erase(std::unordered_map<std::string, Entry>::iterator it)noexcept;
+
+    private:
+        std::shared_ptr<MappedFileCache*> m_pSelf;  // 线程池任务通过它判断缓存是否已经销毁
+        size_t m_uMaxBytes = 0;
+        size_t m_uTotalBytes = 0;
+        uint64_t m_ullHitCount = 0;
+        uint64_t m_ullMissCount = 0;
+
+        std::unordered_map<std::string, Entry> m_stEntries;
+        std::list<std::string> m_stLru;  // 头部为最近使用
+        std::unordered_map<std::string, PendingLoad> m_stPending;
+        std::unordered_map<std::string, DirectoryWatcher> m_stWatchers;  // 以目录前缀（含分隔符）为键
+        size_t m_uClosedWatchers = 0;  // 已关闭但尚未移除的监控，可能处于其自身的回调中，不能立即销毁
+    };
+}
+}
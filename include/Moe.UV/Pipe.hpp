@@ -5,10 +5,12 @@
  */
 #pragma once
 #include "Stream.hpp"
+#include "TcpSocket.hpp"
 
 #include <functional>
 
 struct uv_connect_s;
+struct uv_write_s;
 
 namespace moe
 {
@@ -21,12 +23,24 @@ namespace UV
         public Stream
     {
     public:
+        /**
+         * @brief 通过IPC管道收到的句柄类型
+         */
+        enum class PendingHandleType
+        {
+            Unknown,
+            Tcp,
+            Pipe,
+        };
+
         using OnConnectCallbackType = std::function<void()>;
+        using OnHandleCallbackType = std::function<void(PendingHandleType)>;
 
         static Pipe Create(bool ipc=false);
 
     private:
         static void OnUVConnect(::uv_connect_s* request, int status)noexcept;
+        static void OnUVWriteHandle(::uv_write_s* request, int status)noexcept;
 
     protected:
         using Stream::Stream;
@@ -54,6 +68,42 @@ namespace UV
          */
         void Connect(const char* name);
 
+        /**
+         * @brief 通过IPC管道发送句柄
+         * @param handle 待发送的句柄，仅支持TcpSocket和Pipe
+         * @param cb 回调函数
+         *
+         * 管道必须以ipc模式创建。
+         * 句柄随一个字节的'\0'数据一同发送，接收方的OnData会收到该字节。
+         * 在回调触发前句柄必须保持打开，回调之后即可关闭本地的句柄。
+         */
+        void WriteHandle(Stream& handle, const OnWriteCallbackType& cb);
+        void WriteHandle(Stream& handle, OnWriteCallbackType&& cb);
+
+        /**
+         * @brief 获取待接收的句柄数量
+         */
+        size_t GetPendingHandleCount()const noexcept;
+
+        /**
+         * @brief 获取下一个待接收句柄的类型
+         */
+        PendingHandleType GetPendingHandleType()const noexcept;
+
+        /**
+         * @brief 接收一个TCP句柄
+         *
+         * 通常在OnHandle回调中调用。
+         */
+        TcpSocket AcceptTcpSocket();
+
+        /**
+         * @brief 接收一个管道句柄
+         *
+         * 通常在OnHandle回调中调用。
+         */
+        Pipe AcceptPipe();
+
         /**
          * @brief 获取本地名称
          */
@@ -69,11 +119,23 @@ namespace UV
         void SetOnConnectCallback(const OnConnectCallbackType& cb) { m_pOnConnect = cb; }
         void SetOnConnectCallback(OnConnectCallbackType&& cb)noexcept { m_pOnConnect = std::move(cb); }
 
+        /**
+         * @brief 句柄到达回调
+         *
+         * 在收到数据前触发，回调中应当调用AcceptTcpSocket或AcceptPipe接收句柄，否则句柄会被直接关闭。
+         */
+        const OnHandleCallbackType& GetOnHandleCallback()const noexcept { return m_pOnHandle; }
+        void SetOnHandleCallback(const OnHandleCallbackType& cb) { m_pOnHandle = cb; }
+        void SetOnHandleCallback(OnHandleCallbackType&& cb)noexcept { m_pOnHandle = std::move(cb); }
+
     protected:  // 事件
         void OnConnect();
+        void OnHandle(PendingHandleType type);
+        void OnData(BytesView data)override;
 
     private:
         OnConnectCallbackType m_pOnConnect;
+        OnHandleCallbackType m_pOnHandle;
     };
 }
 }
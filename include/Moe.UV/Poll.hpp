@@ -17,6 +17,14 @@ namespace UV
 {
     /**
      * @brief Poll句柄
+     *
+     * 默认为水平触发，fd上的数据未读尽时每轮循环都会触发回调。
+     * 边沿触发模式下回调触发后对应事件暂停监听，使用方需要将fd读写至EAGAIN后调用Rearm恢复，
+     * 适用于数据库驱动等外部库自行消费fd的场景。
+     *
+     * 注意：边沿触发模式下若监听的事件均已触发，在Rearm之前句柄处于停止状态（uv_is_active为false），
+     * 不会使RunLoop::Run保持运行。若外部库会在之后的某个时刻才消费完fd（如等待线程池或其他句柄），
+     * 需要由那些句柄或请求保持RunLoop运行，否则Run可能提前返回。
      */
     class Poll :
         public AsyncHandle
@@ -47,11 +55,25 @@ namespace UV
         Poll& operator=(Poll&& rhs)noexcept;
 
     public:
+        /**
+         * @brief 是否为边沿触发模式
+         */
+        bool IsEdgeTriggered()const noexcept { return m_bEdgeTriggered; }
+
         /**
          * @brief 激活句柄
          * @param events 监听的事件
+         * @param edgeTriggered 是否使用边沿触发
+         */
+        void Start(int events, bool edgeTriggered=false);
+
+        /**
+         * @brief 恢复边沿触发模式下暂停的事件
+         *
+         * 必须在fd读写至EAGAIN（或由外部库确认已消费完毕）之后调用，否则会立即再次触发。
+         * 可以在回调中调用。所有事件均暂停时句柄处于停止状态，Rearm后重新激活。
          */
-        void Start(int events);
+        void Rearm();
 
         /**
          * @brief 终止句柄
@@ -75,6 +97,12 @@ namespace UV
         void OnEvent(int status, int events);
 
     private:
+        void Disarm(int events)noexcept;
+
+    private:
+        int m_iEvents = 0;
+        int m_iArmedEvents = 0;
+        bool m_bEdgeTriggered = false;
         OnEventCallbackType m_pOnEvent;
     };
 }
@@ -0,0 +1,180 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include "Pipe.hpp"
+#include "Timer.hpp"
+#include "Process.hpp"
+#include "TcpSocket.hpp"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace moe
+{
+namespace UV
+{
+    /**
+     * @brief 预派生模式的连接分发器（主进程）
+     *
+     * - 主进程负责监听和接受连接，通过IPC管道将连接分发给子进程。
+     * - 子进程由SubProcess::Spawn创建，IPC管道固定位于子进程的kChannelFd描述符上，子进程使用PreforkWorker接收连接。
+     * - 每次总是选择在途连接最少的子进程，相同时轮询。
+     * - 子进程异常退出后会延迟重新拉起。
+     */
+    class PreforkMaster :
+        public NonCopyable
+    {
+    public:
+        using OnWorkerExitCallbackType = std::function<void(size_t, int64_t, int)>;  // (index, exitStatus, termSignal)
+
+        /**
+         * @brief 子进程中IPC管道的文件描述符
+         */
+        static const int kChannelFd = 3;
+
+        /**
+         * @brief 子进程重启延迟（毫秒）
+         */
+        static const Time::Tick kRespawnDelay = 1000;
+
+    public:
+        /**
+         * @brief 构造分发器并拉起子进程
+         * @param path 子进程路径
+         * @param args 额外的命令行参数，不包含argv[0]
+         * @param workerCount 子进程数量
+         */
+        PreforkMaster(const std::string& path, const std::vector<std::string>& args, size_t workerCount);
+        ~PreforkMaster();
+
+        PreforkMaster(PreforkMaster&&) = delete;
+        PreforkMaster& operator=(PreforkMaster&&) = delete;
+
+    public:
+        /**
+         * @brief 获取子进程数量
+         */
+        size_t GetWorkerCount()const noexcept { return m_stWorkers.size(); }
+
+        /**
+         * @brief 获取存活的子进程数量
+         */
+        size_t GetAliveWorkerCount()const noexcept;
+
+        /**
+         * @brief 获取监听套接字
+         */
+        TcpSocket& GetListener()noexcept { return m_stListener; }
+
+        /**
+         * @brief 开始监听
+         * @param address 地址
+         * @param backlog 后备队列大小
+         * @param ipv6Only 是否仅IPV6生效
+         */
+        void Listen(const EndPoint& address, unsigned backlog=128, bool ipv6Only=false);
+
+        /**
+         * @brief 关闭分发器
+         *
+         * 停止监听，关闭所有IPC管道并向子进程发送SIGTERM。
+         */
+        void Close()noexcept;
+
+    public:
+        const OnWorkerExitCallbackType& GetOnWorkerExitCallback()const noexcept { return m_pOnWorkerExit; }
+        void SetOnWorkerExitCallback(const OnWorkerExitCallbackType& cb) { m_pOnWorkerExit = cb; }
+        void SetOnWorkerExitCallback(OnWorkerExitCallbackType&& cb)noexcept { m_pOnWorkerExit = std::move(cb); }
+
+    protected:  // 事件
+        void OnWorkerExit(size_t index, int64_t exitStatus, int termSignal);
+
+    private:
+        struct Worker
+        {
+            Pipe Channel;
+            SubProcess Process;
+            size_t InFlight = 0;
+            bool Alive = true;
+
+            Worker(Pipe&& channel, SubProcess&& process)
+                : Channel(std::move(channel)), Process(std::move(process)) {}
+        };
+
+        void SpawnWorker(size_t index);
+        void RespawnDeadWorkers();
+        Worker* SelectWorker()noexcept;
+        void OnConnection();
+
+    private:
+        std::string m_stPath;
+        std::vector<std::string> m_stArgs;
+        bool m_bClosed = false;
+        size_t m_uNextWorker = 0;
+
+        TcpSocket m_stListener;
+        Timer m_stRespawnTimer;
+        std::vector<std::unique_ptr<Worker>> m_stWorkers;
+        std::list<TcpSocket> m_stHandOff;  // 正在发送给子进程的连接
+
+        OnWorkerExitCallbackType m_pOnWorkerExit;
+    };
+
+    /**
+     * @brief 预派生模式的连接接收器（子进程）
+     *
+     * 从PreforkMaster::kChannelFd上的IPC管道接收主进程分发的连接。
+     */
+    class PreforkWorker :
+        public NonCopyable
+    {
+    public:
+        using OnConnectionCallbackType = std::function<void(TcpSocket&&)>;
+        using OnMasterExitCallbackType = std::function<void()>;
+
+    public:
+        PreforkWorker();
+
+        PreforkWorker(PreforkWorker&&) = delete;
+        PreforkWorker& operator=(PreforkWorker&&) = delete;
+
+    public:
+        /**
+         * @brief 开始接收连接
+         */
+        void Start();
+
+        /**
+         * @brief 关闭IPC管道
+         */
+        void Close()noexcept;
+
+    public:
+        const OnConnectionCallbackType& GetOnConnectionCallback()const noexcept { return m_pOnConnection; }
+        void SetOnConnectionCallback(const OnConnectionCallbackType& cb) { m_pOnConnection = cb; }
+        void SetOnConnectionCallback(OnConnectionCallbackType&& cb)noexcept { m_pOnConnection = std::move(cb); }
+
+        /**
+         * @brief 主进程退出或IPC管道断开时触发
+         */
+        const OnMasterExitCallbackType& GetOnMasterExitCallback()const noexcept { return m_pOnMasterExit; }
+        void SetOnMasterExitCallback(const OnMasterExitCallbackType& cb) { m_pOnMasterExit = cb; }
+        void SetOnMasterExitCallback(OnMasterExitCallbackType&& cb)noexcept { m_pOnMasterExit = std::move(cb); }
+
+    protected:  // 事件
+        void OnConnection(TcpSocket&& socket);
+        void OnMasterExit();
+
+    private:
+        Pipe m_stChannel;
+
+        OnConnectionCallbackType m_pOnConnection;
+        OnMasterExitCallbackType m_pOnMasterExit;
+    };
+}
+}
@@ -6,6 +6,7 @@
 #pragma once
 #include "AsyncHandle.hpp"
 
+#include <vector>
 #include <functional>
 
 struct uv_process_s;
@@ -15,6 +16,9 @@ namespace moe
 {
 namespace UV
 {
+    class Stream;
+    class Pipe;
+
     /**
      * @brief 进程
      */
@@ -38,6 +42,53 @@ namespace UV
     public:
         using OnExitCallbackType = std::function<void(int64_t, int)>;  // (exitStatus, termSignal)
 
+        /**
+         * @brief 子进程的标准输入输出配置
+         *
+         * 数组下标即子进程中的文件描述符，0、1、2分别对应stdin、stdout、stderr。
+         */
+        struct StdioContainer
+        {
+            enum class Type
+            {
+                Ignore,
+                CreatePipe,
+                InheritFd,
+                InheritStream,
+            };
+
+            Type ContainerType = Type::Ignore;
+            Stream* Target = nullptr;
+            int Fd = -1;
+            bool Readable = false;  // 子进程视角
+            bool Writable = false;  // 子进程视角
+
+            /**
+             * @brief 忽略该描述符
+             */
+            static StdioContainer Ignore()noexcept;
+
+            /**
+             * @brief 创建管道
+             * @param pipe 尚未连接的管道，创建IPC通道时需以ipc模式构造
+             * @param readable 子进程是否可读
+             * @param writable 子进程是否可写
+             */
+            static StdioContainer CreatePipe(Pipe& pipe, bool readable, bool writable)noexcept;
+
+            /**
+             * @brief 继承父进程的文件描述符
+             * @param fd 文件描述符
+             */
+            static StdioContainer InheritFd(int fd)noexcept;
+
+            /**
+             * @brief 继承父进程的流对象
+             * @param stream 流
+             */
+            static StdioContainer InheritStream(Stream& stream)noexcept;
+        };
+
         /**
          * @brief （阻塞）创建并执行进程
          * @param path 进程路径
@@ -52,6 +103,21 @@ namespace UV
         static SubProcess Spawn(const char* path, const char* args[], const char* env[]=nullptr,
             const char* cwd=nullptr, unsigned flags=0, uint32_t uid=0, uint32_t gid=0);
 
+        /**
+         * @brief （阻塞）创建并执行进程
+         * @param path 进程路径
+         * @param args 命令行参数，以nullptr结尾的数组，其中argv[0]必须为进程路径
+         * @param stdio 子进程的标准输入输出配置
+         * @param env 执行环境，若为nullptr则继承父进程
+         * @param cwd 工作目录，若为nullptr则继承父进程
+         * @param flags 见uv_process_flags
+         * @param uid 用户ID
+         * @param gid 组ID
+         * @return 进程对象
+         */
+        static SubProcess Spawn(const char* path, const char* args[], const std::vector<StdioContainer>& stdio,
+            const char* env[]=nullptr, const char* cwd=nullptr, unsigned flags=0, uint32_t uid=0, uint32_t gid=0);
+
     private:
         static void OnUVProcessExit(::uv_process_s* handle, int64_t exitStatus, int termSignal)noexcept;
 
@@ -0,0 +1,206 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include "Pipe.hpp"
+#include "Timer.hpp"
+#include "Process.hpp"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace moe
+{
+namespace UV
+{
+    /**
+     * @brief 常驻子进程池（主进程）
+     *
+     * - 预先拉起固定数量的子进程，避免每个请求都fork的开销，适用于CPU密集或需要隔离的任务。
+     * - 主进程与子进程之间通过位于子进程kChannelFd上的管道通信，请求和响应均为4字节大端长度前缀加数据。
+     * - 每个子进程同一时刻只处理一个任务，没有空闲子进程时任务进入队列。
+     * - 子进程退出后延迟重新拉起，执行中的任务以UV_ECONNRESET回调失败。
+     * - 子进程使用ProcessPoolWorker接收任务。
+     */
+    class ProcessPool :
+        public NonCopyable
+    {
+    public:
+        using OnResponseCallbackType = std::function<void(int, BytesView)>;  // (status, response)
+        using OnWorkerExitCallbackType = std::function<void(size_t, int64_t, int)>;  // (index, exitStatus, termSignal)
+
+        /**
+         * @brief 子进程中通信管道的文件描述符
+         */
+        static const int kChannelFd = 3;
+
+        /**
+         * @brief 子进程重启延迟（毫秒）
+         */
+        static const Time::Tick kRespawnDelay = 1000;
+
+        /**
+         * @brief 单个请求或响应的最大长度
+         */
+        static const uint32_t kMaxFrameSize = 64 * 1024 * 1024;
+
+    public:
+        /**
+         * @brief 构造进程池并拉起子进程
+         * @param path 子进程路径
+         * @param args 额外的命令行参数，不包含argv[0]
+         * @param workerCount 子进程数量
+         */
+        ProcessPool(const std::string& path, const std::vector<std::string>& args, size_t workerCount);
+        ~ProcessPool();
+
+        ProcessPool(ProcessPool&&) = delete;
+        ProcessPool& operator=(ProcessPool&&) = delete;
+
+    public:
+        /**
+         * @brief 获取子进程数量
+         */
+        size_t GetWorkerCount()const noexcept { return m_stWorkers.size(); }
+
+        /**
+         * @brief 获取存活的子进程数量
+         */
+        size_t GetAliveWorkerCount()const noexcept;
+
+        /**
+         * @brief 获取排队中的任务数量
+         */
+        size_t GetQueuedJobCount()const noexcept { return m_stQueue.size(); }
+
+        /**
+         * @brief 提交任务
+         * @param job 请求数据，会被复制
+         * @param cb 完成回调
+         */
+        void Submit(BytesView job, const OnResponseCallbackType& cb);
+        void Submit(BytesView job, OnResponseCallbackType&& cb);
+
+        /**
+         * @brief 关闭进程池
+         *
+         * 关闭所有管道并向子进程发送SIGTERM，未完成的任务以UV_ECANCELED回调失败。
+         */
+        void Close()noexcept;
+
+    public:
+        const OnWorkerExitCallbackType& GetOnWorkerExitCallback()const noexcept { return m_pOnWorkerExit; }
+        void SetOnWorkerExitCallback(const OnWorkerExitCallbackType& cb) { m_pOnWorkerExit = cb; }
+        void SetOnWorkerExitCallback(OnWorkerExitCallbackType&& cb)noexcept { m_pOnWorkerExit = std::move(cb); }
+
+    protected:  // 事件
+        void OnWorkerExit(size_t index, int64_t exitStatus, int termSignal);
+
+    private:
+        struct Job
+        {
+            std::vector<uint8_t> Payload;
+            OnResponseCallbackType OnResponse;
+        };
+
+        struct Worker
+        {
+            Pipe Channel;
+            SubProcess Process;
+            bool Alive = true;
+            bool Busy = false;
+            OnResponseCallbackType OnResponse;  // 执行中任务的回调
+            std::vector<uint8_t> ReadBuffer;
+
+            Worker(Pipe&& channel, SubProcess&& process)
+                : Channel(std::move(channel)), Process(std::move(process)) {}
+        };
+
+        void SpawnWorker(size_t index);
+        void RespawnDeadWorkers();
+        void Dispatch(Worker& worker, BytesView job, OnResponseCallbackType&& cb);
+        void DispatchQueued();
+        void FailWorker(Worker& worker, int status)noexcept;
+
+    private:
+        std::string m_stPath;
+        std::vector<std::string> m_stArgs;
+        bool m_bClosed = false;
+        size_t m_uNextWorker = 0;
+
+        Timer m_stRespawnTimer;
+        std::vector<std::unique_ptr<Worker>> m_stWorkers;
+        std::deque<Job> m_stQueue;
+
+        OnWorkerExitCallbackType m_pOnWorkerExit;
+    };
+
+    /**
+     * @brief 常驻子进程池的任务接收器（子进程）
+     *
+     * 从ProcessPool::kChannelFd上的管道接收任务，每个任务必须调用一次Reply作出响应。
+     */
+    class ProcessPoolWorker :
+        public NonCopyable
+    {
+    public:
+        using OnJobCallbackType = std::function<void(BytesView)>;
+        using OnMasterExitCallbackType = std::function<void()>;
+
+    public:
+        ProcessPoolWorker();
+
+        ProcessPoolWorker(ProcessPoolWorker&&) = delete;
+        ProcessPoolWorker& operator=(ProcessPoolWorker&&) = delete;
+
+    public:
+        /**
+         * @brief 开始接收任务
+         */
+        void Start();
+
+        /**
+         * @brief 响应当前任务
+         * @param response 响应数据，会被复制
+         *
+         * 可以在OnJob回调中同步调用，也可以稍后异步调用。
+         */
+        void Reply(BytesView response);
+
+        /**
+         * @brief 关闭管道
+         */
+        void Close()noexcept;
+
+    public:
+        const OnJobCallbackType& GetOnJobCallback()const noexcept { return m_pOnJob; }
+        void SetOnJobCallback(const OnJobCallbackType& cb) { m_pOnJob = cb; }
+        void SetOnJobCallback(OnJobCallbackType&& cb)noexcept { m_pOnJob = std::move(cb); }
+
+        /**
+         * @brief 主进程退出或管道断开时触发
+         */
+        const OnMasterExitCallbackType& GetOnMasterExitCallback()const noexcept { return m_pOnMasterExit; }
+        void SetOnMasterExitCallback(const OnMasterExitCallbackType& cb) { m_pOnMasterExit = cb; }
+        void SetOnMasterExitCallback(OnMasterExitCallbackType&& cb)noexcept { m_pOnMasterExit = std::move(cb); }
+
+    protected:  // 事件
+        void OnJob(BytesView job);
+        void OnMasterExit();
+
+    private:
+        void OnData(BytesView data);
+
+    private:
+        Pipe m_stChannel;
+        std::vector<uint8_t> m_stReadBuffer;
+
+        OnJobCallbackType m_pOnJob;
+        OnMasterExitCallbackType m_pOnMasterExit;
+    };
+}
+}
@@ -0,0 +1,142 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include "Timer.hpp"
+#include "FsEvent.hpp"
+
+#include <map>
+#include <deque>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace moe
+{
+namespace UV
+{
+    /**
+     * @brief 递归目录监控
+     *
+     * - Windows和macOS上直接使用FsEvent的递归模式，其他平台上为每个子目录各建立一个FsEvent，
+     *   并在子目录创建、删除时自动增减。
+     * - 同一路径在合并窗口内的多次事件会被合并，窗口结束时以一次回调批量通知，窗口从第一个事件开始计时。
+     * - 新出现的子目录中已有的文件会作为UV_RENAME事件一并通知，避免建立监控前的变化被遗漏。
+     * - 启动时同步遍历整个目录树，应当在启动阶段调用。
+     * - 运行中新出现的目录树分批遍历，每次通知至多遍历kMaxScanPerFlush个目录，其余的在之后的迭代中继续，
+     *   避免长时间阻塞RunLoop。
+     */
+    class RecursiveFsWatcher :
+        public NonCopyable
+    {
+    public:
+        struct Change
+        {
+            std::string Path;  // 相对于根目录的路径，以'/'分隔
+            int Events = 0;  // UV_RENAME和UV_CHANGE的组合
+        };
+
+        using OnChangesCallbackType = std::function<void(const std::vector<Change>&)>;
+        using OnErrorCallbackType = std::function<void(const std::string&, int)>;  // (path, status)
+
+        static const Time::Tick kDefaultCoalesceWindow = 100;
+        static const size_t kMaxScanPerFlush = 64;
+
+    public:
+        /**
+         * @brief 构造监控器
+         * @param window 合并窗口（毫秒）
+         */
+        explicit RecursiveFsWatcher(Time::Tick window=kDefaultCoalesceWindow);
+        ~RecursiveFsWatcher();
+
+        RecursiveFsWatcher(RecursiveFsWatcher&&) = delete;
+        RecursiveFsWatcher& operator=(RecursiveFsWatcher&&) = delete;
+
+    public:
+        /**
+         * @brief 是否正在监控
+         */
+        bool IsWatching()const noexcept { return m_bWatching; }
+
+        /**
+         * @brief 获取合并窗口（毫秒）
+         */
+        Time::Tick GetCoalesceWindow()const noexcept { return m_ullWindow; }
+
+        /**
+         * @brief 获取根目录
+         */
+        const std::string& GetRoot()const noexcept { return m_stRoot; }
+
+        /**
+         * @brief 获取底层FsEvent的数量
+         */
+        size_t GetWatchCount()const noexcept { return m_stWatchers.size(); }
+
+        /**
+         * @brief 开始监控
+         * @param root 根目录
+         *
+         * 子目录无法监控时通过OnError通知，不会中断启动。
+         */
+        void Start(const std::string& root);
+
+        /**
+         * @brief 停止监控
+         *
+         * 尚未通知的事件会被丢弃。
+         */
+        void Stop()noexcept;
+
+    public:
+        const OnChangesCallbackType& GetOnChangesCallback()const noexcept { return m_pOnChanges; }
+        void SetOnChangesCallback(const OnChangesCallbackType& cb) { m_pOnChanges = cb; }
+        void SetOnChangesCallback(OnChangesCallbackType&& cb)noexcept { m_pOnChanges = std::move(cb); }
+
+        const OnErrorCallbackType& GetOnErrorCallback()const noexcept { return m_pOnError; }
+        void SetOnErrorCallback(const OnErrorCallbackType& cb) { m_pOnError = cb; }
+        void SetOnErrorCallback(OnErrorCallbackType&& cb)noexcept { m_pOnError = std::move(cb); }
+
+    protected:  // 事件
+        void OnChanges(const std::vector<Change>& changes);
+        void OnError(const std::string& path, int status);
+
+    private:
+        struct ScanTask
+        {
+            std::string Path;
+            bool ReportCreated = false;  // 是否将其中已有的条目作为新建通知
+        };
+
+        std::string ToAbsolute(const std::string& relative)const;
+        int AddWatch(const std::string& relative, unsigned flags);
+        void ScanDirectory(const ScanTask& task, std::vector<Change>& created);
+        void Walk(size_t budget, std::vector<Change>& created);
+        void RemoveTree(const std::string& relative)noexcept;
+        bool IsSelfEvent(const std::string& relative)const;
+        void Record(const std::string& relative, int events);
+        void RecordError(const std::string& relative, int status);
+        void OnFsEvent(const std::string& directory, const char* filename, int events, int status)noexcept;
+        void Flush();
+
+    private:
+        Time::Tick m_ullWindow = 0;
+        std::string m_stRoot;
+        bool m_bWatching = false;
+        bool m_bRecursiveNative = false;
+
+        Timer m_stFlushTimer;
+        std::map<std::string, FsEvent> m_stWatchers;  // 以相对目录为键，有序以便按前缀删除
+        std::deque<ScanTask> m_stScanQueue;  // 尚未遍历的目录
+        std::vector<Change> m_stPending;
+        std::unordered_map<std::string, size_t> m_stPendingIndex;
+        std::vector<std::pair<std::string, int>> m_stPendingErrors;
+
+        OnChangesCallbackType m_pOnChanges;
+        OnErrorCallbackType m_pOnError;
+    };
+}
+}
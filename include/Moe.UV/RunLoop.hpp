@@ -8,6 +8,10 @@
 #include <Moe.Core/Utils.hpp>
 
 #include "AsyncHandle.hpp"
+#include "RunLoopStats.hpp"
+
+#include <atomic>
+#include <memory>
 
 struct uv_loop_s;
 
@@ -28,6 +32,31 @@ namespace UV
 
     public:
         using CallbackType = std::function<void()>;
+        using EnumHandlesCallbackType = std::function<void(AsyncHandle&)>;
+
+        /**
+         * @brief 用户回调范围
+         *
+         * 由MOE_UV_CATCH_ALL_BEGIN自动创建，用于回调耗时统计（嵌套时只统计最外层）、活动记录和Tracing。
+         * 均未启用时仅有一次原子变量和一次线程局部变量的读取。
+         */
+        class CallbackScope :
+            public NonCopyable
+        {
+        public:
+            explicit CallbackScope(const char* site)noexcept;
+            ~CallbackScope();
+
+        private:
+            RunLoop* m_pLoop = nullptr;
+            const char* m_pSite = nullptr;
+            const char* m_pPrevSite = nullptr;
+            bool m_bTraced = false;
+            bool m_bTracked = false;
+            bool m_bStamped = false;
+            bool m_bTimed = false;
+            uint64_t m_ullStart = 0;
+        };
 
         /**
          * @brief 获取当前线程上的RunLoop
@@ -42,8 +71,17 @@ namespace UV
          */
         static Time::Tick Now()noexcept;
 
+        /**
+         * @brief 获取当前高精度时间戳（纳秒级）
+         *
+         * 该值不会被RunLoop缓存，每次调用都会读取单调时钟。
+         * 与HighResolutionTimer使用相同的时钟源。
+         */
+        static uint64_t NowNanos()noexcept;
+
     private:
         static void UVClosingHandleWalker(::uv_handle_s* handle, void* arg)noexcept;
+        static void UVEnumHandleWalker(::uv_handle_s* handle, void* arg)noexcept;
 
     public:
         /**
@@ -81,6 +119,18 @@ namespace UV
          */
         void Run();
 
+        /**
+         * @brief 以忙轮询方式启动程序循环
+         * @param spinBudget 没有事件时持续自旋的时间（微秒）
+         *
+         * - 与Run相同，运行循环直到所有句柄结束或调用Stop。
+         * - 每处理完一轮事件后不进入阻塞等待，而是在spinBudget内持续检查新的I/O事件和到期的定时器，以降低唤醒延迟，代价是占满一个核心。
+         * - 超出预算仍没有事件时阻塞等待一次，之后重新开始自旋。
+         * - 可配合TcpSocket::SetBusyPoll/UdpSocket::SetBusyPoll让内核同时忙轮询网卡队列。
+         * - 依赖libuv的轮询后端描述符，Windows上抛出InvalidCallException。
+         */
+        void RunBusyPoll(unsigned spinBudget);
+
         /**
          * @brief 尽快结束循环
          *
@@ -99,6 +149,42 @@ namespace UV
          */
         void ForceCloseAllHandle()noexcept;
 
+        /**
+         * @brief 优雅地关闭所有数据流
+         * @param timeout 最长等待时间（毫秒）
+         * @param onStraggler 超时后对每个仍未关闭的数据流调用一次，可用于记录日志或强制关闭
+         * @return 超时后仍未关闭的数据流数量
+         *
+         * - 侦听中的句柄立即关闭，不再接受新连接。
+         * - 写队列为空的数据流视为空闲，立即关闭。
+         * - 其余数据流在写屏障解除后发起Shutdown，待数据全部写出后，若仍在读取则等待对端关闭，以免未读数据导致连接被重置。
+         * - 等待期间RunLoop照常处理事件，没有事件时阻塞在轮询中，数据流以外的句柄不受影响。
+         * - 必须在RunLoop线程上、Run之外调用，例如在回调中Stop使Run返回之后。
+         */
+        size_t Drain(Time::Tick timeout, const EnumHandlesCallbackType& onStraggler=nullptr);
+
+        /**
+         * @brief 枚举所有存活的句柄
+         * @param cb 回调，对每个未关闭的Moe.UV句柄调用一次
+         *
+         * - 外部库共享libuv的句柄和正在关闭的句柄会被跳过。
+         * - 可以结合AsyncHandle::GetTypeName和AsyncHandle::GetIoStats按类型筛选、排序连接。
+         * - 回调中可以关闭或销毁句柄，回调中新建的句柄不会被枚举。
+         */
+        void EnumHandles(const EnumHandlesCallbackType& cb);
+
+        /**
+         * @brief 新建的Stream和UdpSocket是否默认启用I/O计数
+         */
+        bool IsIoStatsEnabledByDefault()const noexcept { return m_bIoStatsByDefault; }
+
+        /**
+         * @brief 设置新建的Stream和UdpSocket是否默认启用I/O计数
+         *
+         * 仅影响之后创建的句柄（包括Accept得到的连接），已有句柄需单独调用SetIoStatsEnabled。
+         */
+        void SetIoStatsEnabledByDefault(bool enabled)noexcept { m_bIoStatsByDefault = enabled; }
+
         /**
          * @brief 立即更新滴答数
          */
@@ -109,11 +195,117 @@ namespace UV
          */
         Time::Tick GetCurrentTime()const noexcept;
 
+        /**
+         * @brief 是否启用了运行统计
+         */
+        bool IsStatsEnabled()const noexcept { return m_pStats != nullptr; }
+
+        /**
+         * @brief 启用或关闭运行统计
+         *
+         * 启用后通过prepare/check句柄记录每次迭代的轮询等待时间，并统计用户回调的耗时。
+         * 关闭时丢弃已有的数据。
+         */
+        void SetStatsEnabled(bool enabled);
+
+        /**
+         * @brief 获取运行统计的快照
+         *
+         * 未启用时返回空的统计。
+         */
+        RunLoopStats GetStats()const;
+
+        /**
+         * @brief 清空运行统计
+         */
+        void ResetStats()noexcept;
+
+        /**
+         * @brief 启用或关闭活动记录
+         *
+         * 启用后记录正在执行的回调以及RunLoop开始忙碌的时间，供看门狗等在其他线程上诊断卡顿。
+         * 可以嵌套调用，启用与关闭需要配对。
+         */
+        void SetActivityTrackingEnabled(bool enabled);
+
+        /**
+         * @brief 获取正在执行的回调
+         * @return 回调所在的函数签名，未在回调中或未启用活动记录时返回nullptr
+         *
+         * 线程安全。
+         */
+        const char* GetCurrentCallback()const noexcept { return m_stCurrentCallback.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief 获取本次迭代开始忙碌的时间
+         * @return 纳秒时间戳（参见NowNanos），在轮询中等待、循环未在运行或未启用活动记录时返回0
+         *
+         * 线程安全。
+         */
+        uint64_t GetBusySince()const noexcept { return m_ullBusySince.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief 获取内存池分配统计的快照
+         *
+         * 线程安全，各分类之间不保证是同一时刻的值。
+         */
+        AllocStats GetAllocStats()const noexcept;
+
+        /**
+         * @brief 将各分类的峰值重置为当前存活值
+         *
+         * 线程安全。
+         */
+        void ResetAllocPeaks()noexcept;
+
+        /**
+         * @brief 记录一次分配
+         *
+         * 由Moe.UV内部在RunLoop线程上调用。
+         */
+        void RecordAlloc(AllocCategory category, size_t size)noexcept;
+
+        /**
+         * @brief 记录一次释放
+         *
+         * 由Moe.UV内部在RunLoop线程上调用。
+         */
+        void RecordFree(AllocCategory category, size_t size)noexcept;
+
+    private:
+        struct AllocCounter
+        {
+            // 仅由RunLoop线程写入，其他线程只读
+            std::atomic<size_t> Live;
+            std::atomic<size_t> Peak;
+            std::atomic<uint64_t> Allocs;
+        };
+
+        struct StatsContext;
+        struct ActivityContext;
+
+        void OnStatsPrepare()noexcept;
+        void OnStatsCheck()noexcept;
+        void ClearActivity()noexcept;
+
+        size_t DrainStreams();
+
     private:
         ObjectPool& m_stObjectPool;
 
         UniquePooledObject<::uv_loop_s> m_pHandle;
         bool m_bClosing = false;
+        bool m_bStopRequested = false;  // uv_run每次返回时会清除uv_stop的标记，RunBusyPoll需要自行记录
+        bool m_bIoStatsByDefault = false;
+
+        std::unique_ptr<StatsContext> m_pStats;
+
+        unsigned m_uActivityTrackers = 0;
+        std::unique_ptr<ActivityContext> m_pActivity;
+        std::atomic<const char*> m_stCurrentCallback;
+        std::atomic<uint64_t> m_ullBusySince;
+
+        AllocCounter m_stAllocCounters[static_cast<size_t>(AllocCategory::Count)];
     };
 }
 }
@@ -0,0 +1,154 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace moe
+{
+namespace UV
+{
+    /**
+     * @brief 耗时直方图
+     *
+     * - 按数量级分桶，每个数量级再线性细分为kSubBucketCount个桶，相对误差约为3%（HDR Histogram的做法）。
+     * - 记录为O(1)且不分配内存，超过kMaxValue的值会被截断。
+     * - 单位由使用方决定，RunLoop中统一为纳秒。
+     */
+    class LatencyHistogram
+    {
+    public:
+        static const unsigned kSubBucketBits = 5;
+        static const uint64_t kSubBucketCount = 1ull << kSubBucketBits;
+        static const unsigned kMaxMagnitude = 40;  // 纳秒时约18分钟
+        static const uint64_t kMaxValue = (1ull << kMaxMagnitude) - 1;
+
+    public:
+        LatencyHistogram();
+
+    public:
+        /**
+         * @brief 获取样本数量
+         */
+        uint64_t GetCount()const noexcept { return m_ullCount; }
+
+        /**
+         * @brief 获取最小值
+         */
+        uint64_t GetMin()const noexcept { return m_ullCount ? m_ullMin : 0; }
+
+        /**
+         * @brief 获取最大值
+         */
+        uint64_t GetMax()const noexcept { return m_ullMax; }
+
+        /**
+         * @brief 获取样本总和
+         */
+        uint64_t GetSum()const noexcept { return m_ullSum; }
+
+        /**
+         * @brief 获取平均值
+         */
+        double GetMean()const noexcept { return m_ullCount ? static_cast<double>(m_ullSum) / m_ullCount : 0.; }
+
+        /**
+         * @brief 获取百分位数
+         * @param percentile 百分位，取值[0, 100]
+         * @return 对应桶的上界，不超过实际最大值
+         */
+        uint64_t GetPercentile(double percentile)const noexcept;
+
+        /**
+         * @brief 记录样本
+         */
+        void Record(uint64_t value)noexcept;
+
+        /**
+         * @brief 合并另一个直方图
+         */
+        void Merge(const LatencyHistogram& rhs)noexcept;
+
+        /**
+         * @brief 清空
+         */
+        void Reset()noexcept;
+
+    private:
+        static size_t GetBucketIndex(uint64_t value)noexcept;
+        static uint64_t GetBucketUpperBound(size_t index)noexcept;
+
+    private:
+        std::vector<uint64_t> m_stBuckets;
+        uint64_t m_ullCount = 0;
+        uint64_t m_ullMin = 0;
+        uint64_t m_ullMax = 0;
+        uint64_t m_ullSum = 0;
+    };
+
+    /**
+     * @brief RunLoop的运行统计
+     *
+     * 所有时间单位均为纳秒。
+     */
+    struct RunLoopStats
+    {
+        uint64_t Iterations = 0;  // 循环迭代次数
+        uint64_t Callbacks = 0;  // 用户回调次数
+        uint64_t TotalIdleTime = 0;  // 累计在轮询中等待的时间
+        uint64_t TotalCallbackTime = 0;  // 累计在用户回调中的时间
+
+        LatencyHistogram LoopLag;  // 每次迭代中从轮询返回到下一次进入轮询的时间，即新事件最坏的等待时间
+        LatencyHistogram IdleTime;  // 每次轮询的等待时间
+        LatencyHistogram CallbackTime;  // 单次用户回调的耗时
+    };
+
+    /**
+     * @brief 内存分配分类
+     */
+    enum class AllocCategory
+    {
+        Handle,  // libuv句柄
+        ReadBuffer,  // 读缓冲区（包括转发中的数据）
+        WriteCopy,  // 写操作拷贝的数据
+        Request,  // 写、连接、文件等请求
+        Dns,  // DNS请求
+        Work,  // 线程池任务
+        Count,
+    };
+
+    /**
+     * @brief 获取分类名称
+     */
+    const char* GetAllocCategoryName(AllocCategory category)noexcept;
+
+    /**
+     * @brief RunLoop内存池的分配统计
+     *
+     * 所有大小单位均为字节，只统计请求的大小，不包括对象池自身的对齐和管理开销。
+     */
+    struct AllocStats
+    {
+        struct Entry
+        {
+            size_t Live = 0;  // 当前存活的字节数
+            size_t Peak = 0;  // 存活字节数的峰值
+            uint64_t Allocs = 0;  // 累计分配次数
+        };
+
+        Entry Categories[static_cast<size_t>(AllocCategory::Count)];
+
+        const Entry& operator[](AllocCategory category)const noexcept { return Categories[static_cast<size_t>(category)]; }
+        Entry& operator[](AllocCategory category)noexcept { return Categories[static_cast<size_t>(category)]; }
+
+        /**
+         * @brief 获取所有分类存活字节数之和
+         */
+        size_t GetTotalLive()const noexcept;
+    };
+}
+}
@@ -0,0 +1,182 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include "Poll.hpp"
+
+#include <deque>
+#include <vector>
+
+namespace moe
+{
+namespace UV
+{
+#ifdef MOE_LINUX
+    /**
+     * @brief 基于共享内存的进程间消息流
+     *
+     * - 共享内存（memfd）上包含两个方向的单生产者单消费者环形缓冲区，两个端点分别位于不同进程（或线程）中。
+     * - 数据以消息为单位传递，收发不经过内核拷贝；每个端点有一个eventfd，仅在对端休眠（缓冲区空或满）时才写入唤醒。
+     * - OnData收到的数据直接指向共享内存，仅在回调期间有效。
+     * - 对端进程异常退出不会被感知，需要配合SubProcess的退出回调等机制使用。
+     * - 仅Linux可用。
+     */
+    class SharedMemoryStream :
+        public NonCopyable
+    {
+    public:
+        using OnDataCallbackType = std::function<void(BytesView)>;
+        using OnEofCallbackType = std::function<void()>;
+        using OnErrorCallbackType = std::function<void(int)>;
+
+        /**
+         * @brief 描述一组共享内存通道的文件描述符
+         */
+        struct Descriptors
+        {
+            int Memory = -1;
+            int Notify[2] = { -1, -1 };  // 两个端点各自等待的eventfd
+        };
+
+        /**
+         * @brief 默认每个方向的缓冲区大小
+         */
+        static const size_t kDefaultCapacity = 4 * 1024 * 1024;
+
+        /**
+         * @brief 单次回调中最多处理的消息数
+         *
+         * 超出后让出RunLoop，剩余消息在下一轮处理。
+         */
+        static const size_t kMaxBatchSize = 1024;
+
+        /**
+         * @brief 创建共享内存及eventfd
+         * @param capacity 每个方向的缓冲区大小，必须为2的幂且不小于4KB
+         * @return 文件描述符，带有CLOEXEC标志，可以通过SubProcess::StdioContainer::InheritFd传给子进程
+         *
+         * 端点构造时会复制文件描述符，调用方在完成分发后需要调用Release关闭。
+         */
+        static Descriptors Allocate(size_t capacity=kDefaultCapacity);
+
+        /**
+         * @brief 关闭Allocate返回的文件描述符
+         */
+        static void Release(Descriptors& fds)noexcept;
+
+    public:
+        /**
+         * @brief 打开端点
+         * @param fds 文件描述符
+         * @param side 端点编号，0或1，通信双方必须不同
+         */
+        SharedMemoryStream(const Descriptors& fds, unsigned side);
+        ~SharedMemoryStream();
+
+        SharedMemoryStream(SharedMemoryStream&&) = delete;
+        SharedMemoryStream& operator=(SharedMemoryStream&&) = delete;
+
+    public:
+        /**
+         * @brief 是否已关闭
+         */
+        bool IsClosed()const noexcept { return m_bClosed; }
+
+        /**
+         * @brief 获取单条消息的最大长度
+         */
+        size_t GetMaxMessageSize()const noexcept { return m_uCapacity / 2 - 8; }
+
+        /**
+         * @brief 获取因缓冲区已满而暂存在本地的字节数
+         */
+        size_t GetQueuedBytes()const noexcept { return m_uQueuedBytes; }
+
+        /**
+         * @brief 发送消息
+         * @param buf 数据，缓冲区已满时会被复制到本地队列，在对端消费后按顺序写入
+         */
+        void Write(BytesView buf);
+
+        /**
+         * @brief 尝试立即发送消息
+         * @return 缓冲区空间不足或有暂存数据时返回false
+         */
+        bool TryWrite(BytesView buf);
+
+        /**
+         * @brief 开始接收消息
+         */
+        void StartRead();
+
+        /**
+         * @brief 停止接收消息
+         *
+         * 期间对端的写入会在缓冲区满后暂停。
+         */
+        void StopRead()noexcept;
+
+        /**
+         * @brief 关闭端点
+         *
+         * 对端消费完已写入的消息后触发OnEof，本地暂存未写入的数据会被丢弃。
+         */
+        void Close()noexcept;
+
+    public:
+        const OnDataCallbackType& GetOnDataCallback()const noexcept { return m_pOnData; }
+        void SetOnDataCallback(const OnDataCallbackType& cb) { m_pOnData = cb; }
+        void SetOnDataCallback(OnDataCallbackType&& cb)noexcept { m_pOnData = std::move(cb); }
+
+        const OnEofCallbackType& GetOnEofCallback()const noexcept { return m_pOnEof; }
+        void SetOnEofCallback(const OnEofCallbackType& cb) { m_pOnEof = cb; }
+        void SetOnEofCallback(OnEofCallbackType&& cb)noexcept { m_pOnEof = std::move(cb); }
+
+        const OnErrorCallbackType& GetOnErrorCallback()const noexcept { return m_pOnError; }
+        void SetOnErrorCallback(const OnErrorCallbackType& cb) { m_pOnError = cb; }
+        void SetOnErrorCallback(OnErrorCallbackType&& cb)noexcept { m_pOnError = std::move(cb); }
+
+    protected:  // 事件
+        void OnData(BytesView data);
+        void OnEof();
+        void OnError(int error);
+
+    private:
+        struct RingHeader;
+
+        bool Push(BytesView buf)noexcept;
+        void FlushQueue()noexcept;
+        bool Drain();
+        void Signal(int fd)noexcept;
+        void OnEvent(int status, int events);
+
+    private:
+        int m_iMemoryFd = -1;
+        int m_iLocalFd = -1;
+        int m_iRemoteFd = -1;
+        void* m_pMapping = nullptr;
+        size_t m_uMappingSize = 0;
+        size_t m_uCapacity = 0;
+
+        RingHeader* m_pTx = nullptr;
+        RingHeader* m_pRx = nullptr;
+        uint8_t* m_pTxData = nullptr;
+        uint8_t* m_pRxData = nullptr;
+
+        Poll m_stPoll;
+        bool m_bReading = false;
+        bool m_bClosed = false;
+        bool m_bEof = false;
+
+        std::deque<std::vector<uint8_t>> m_stQueue;
+        size_t m_uQueuedBytes = 0;
+
+        OnDataCallbackType m_pOnData;
+        OnEofCallbackType m_pOnEof;
+        OnErrorCallbackType m_pOnError;
+    };
+#endif
+}
+}
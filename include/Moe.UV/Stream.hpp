@@ -5,8 +5,11 @@
  */
 #pragma once
 #include "AsyncHandle.hpp"
+#include "IoStats.hpp"
 
+#include <deque>
 #include <functional>
+#include <memory>
 
 // fvck Windows
 #if defined(_MSC_VER) && !defined(_SSIZE_T_) && !defined(_SSIZE_T_DEFINED)
@@ -31,6 +34,7 @@ namespace UV
         public AsyncHandle
     {
         friend class ObjectPool;
+        friend class RunLoop;
 
     public:
         using OnWriteCallbackType = std::function<void(int)>;
@@ -38,6 +42,14 @@ namespace UV
         using OnShutdownCallbackType = std::function<void()>;
         using OnDataCallbackType = std::function<void(BytesView)>;
         using OnEofCallbackType = std::function<void()>;
+        using OnRelayEndCallbackType = std::function<void(int)>;
+
+        /**
+         * @brief 转发模式下目标写队列的上限
+         *
+         * 超过该值时暂停读取源数据流。
+         */
+        static const size_t kRelayHighWaterMark = 1024 * 1024;
 
     private:
         static void OnUVShutdown(::uv_shutdown_s* request, int status)noexcept;
@@ -46,10 +58,12 @@ namespace UV
         static void OnUVRead(::uv_stream_s* handle, ssize_t nread, const ::uv_buf_t* buf)noexcept;
 
     protected:
-        using AsyncHandle::AsyncHandle;
+        Stream(UniquePooledObject<::uv_handle_s>&& handle);
 
     public:
         Stream(Stream&& org)noexcept;
+        ~Stream();
+
         Stream& operator=(Stream&& rhs)noexcept;
 
     public:
@@ -65,14 +79,35 @@ namespace UV
 
         /**
          * @brief 获取写队列大小
+         *
+         * 包含被写屏障暂存的数据。
          */
         size_t GetWriteQueueSize()const noexcept;
 
+        /**
+         * @brief 是否正在侦听连接
+         */
+        bool IsListening()const noexcept { return m_bListening; }
+
+        /**
+         * @brief 是否已经发起Shutdown
+         *
+         * 若已完成或者正在进行则返回true。
+         */
+        bool IsShuttingDown()const noexcept { return m_bShuttingDown; }
+
+        /**
+         * @brief Shutdown是否已完成
+         *
+         * 完成时写队列中的数据均已交给系统，写端已关闭。
+         */
+        bool IsShutdown()const noexcept { return m_bShutdown; }
+
         /**
          * @brief 关闭数据流
          * @param cb 回调函数
          *
-         * 关闭写端。
+         * 关闭写端。写屏障生效时会排在暂存的写操作之后发起，此后不能再写入。
          */
         void Shutdown();
 
@@ -106,9 +141,60 @@ namespace UV
          * @brief 尝试写数据
          * @param buffer 数据
          * @return 是否成功写
+         *
+         * 写屏障生效或存在暂存的写操作时总是返回false，以保证写顺序。
          */
         bool TryWrite(BytesView buffer);
 
+        /**
+         * @brief 关闭句柄
+         *
+         * 被写屏障暂存的写操作会以UV_ECANCELED回调，暂存的Shutdown被丢弃。
+         */
+        bool Close()noexcept override;
+
+        /**
+         * @brief 将读到的数据原样转发到目标数据流
+         * @param target 目标数据流
+         * @param cb 转发结束时回调，源数据流读到EOF时状态为0
+         *
+         * - Linux下若两端均为TCP或管道，数据通过内核管道splice直接在套接字间移动，不经过用户态。
+         *   此时目标数据流上会设置写屏障，转发期间目标的Write操作会被暂存。
+         * - 其他情况下以读缓冲区本身作为写缓冲区转发，不产生额外拷贝。
+         * - 目标写队列超过kRelayHighWaterMark时暂停读取，队列排空一半后恢复。
+         * - 转发期间源数据流的OnData和OnEof不会触发，也不应调用StartRead/StopRead。
+         * - 任意一端关闭时转发以UV_ECANCELED结束。
+         */
+        void RelayTo(Stream& target, const OnRelayEndCallbackType& cb);
+        void RelayTo(Stream& target, OnRelayEndCallbackType&& cb);
+
+        /**
+         * @brief 停止转发
+         *
+         * 结束回调以UV_ECANCELED触发。
+         */
+        void StopRelay()noexcept;
+
+        /**
+         * @brief 是否正在转发
+         */
+        bool IsRelaying()const noexcept { return m_pRelay != nullptr; }
+
+        /**
+         * @brief 是否启用了I/O计数
+         */
+        bool IsIoStatsEnabled()const noexcept { return m_pIoStats != nullptr; }
+
+        /**
+         * @brief 启用或关闭I/O计数
+         *
+         * 创建时若RunLoop::IsIoStatsEnabledByDefault则自动启用。
+         * 重新启用时计数从零开始。splice转发的数据不经过用户态，不会被计入。
+         */
+        void SetIoStatsEnabled(bool enabled);
+
+        const IoStats* GetIoStats()const noexcept override { return m_pIoStats.get(); }
+
     public:
         const OnErrorCallbackType& GetOnErrorCallback()const noexcept { return m_pOnError; }
         void SetOnErrorCallback(const OnErrorCallbackType& cb) { m_pOnError = cb; }
@@ -126,13 +212,63 @@ namespace UV
         void SetOnEofCallback(const OnEofCallbackType& cb) { m_pOnEof = cb; }
         void SetOnEofCallback(OnEofCallbackType&& cb)noexcept { m_pOnEof = std::move(cb); }
 
+    protected:
+        /**
+         * @brief 设置写屏障
+         * @param cb 屏障之前的写操作全部完成后触发
+         *
+         * - 屏障生效后，Write/WriteNoCopy发起的写操作会被暂存，直到ReleaseWriteBarrier时按顺序提交。
+         * - 屏障生效期间可以继续设置屏障，新的屏障与写操作一同排队，每个屏障都需要对应一次ReleaseWriteBarrier。
+         * - 用于在写队列中插入不经过libuv的写操作（如sendfile），保证整体的写顺序。
+         */
+        void WriteBarrier(OnWriteCallbackType&& cb);
+
+        /**
+         * @brief 解除当前写屏障
+         *
+         * 提交暂存的写操作，直到遇到下一个屏障。
+         */
+        void ReleaseWriteBarrier()noexcept;
+
+        /**
+         * @brief 写屏障是否生效
+         */
+        bool IsWriteBlocked()const noexcept { return m_bWriteBlocked; }
+
+        /**
+         * @brief 标记为侦听状态
+         *
+         * 由派生类在开始侦听后调用。
+         */
+        void SetListening()noexcept { m_bListening = true; }
+
     protected:  // 事件
         void OnError(int error);
         void OnShutdown();
-        void OnData(BytesView data);
+        virtual void OnData(BytesView data);
         void OnEof();
 
     private:
+        struct RelayContext;
+
+        void SubmitWrite(::uv_stream_s* handle, ::uv_write_s* request);
+        void CancelDeferredWrites()noexcept;
+        void DetachRelay()noexcept;
+        void UpdateWriteQueueHighWater(::uv_stream_s* handle)noexcept;
+
+    private:
+        bool m_bListening = false;
+        bool m_bShuttingDown = false;
+        bool m_bShutdown = false;
+        bool m_bWriteBlocked = false;
+        std::deque<::uv_write_s*> m_stDeferredWrites;
+        ::uv_shutdown_s* m_pDeferredShutdown = nullptr;  // 排在写屏障之后的Shutdown
+
+        RelayContext* m_pRelay = nullptr;  // 作为源
+        RelayContext* m_pRelayFrom = nullptr;  // 作为目标
+
+        std::unique_ptr<IoStats> m_pIoStats;
+
         OnErrorCallbackType m_pOnError;
         OnShutdownCallbackType m_pOnShutdown;
         OnDataCallbackType m_pOnData;
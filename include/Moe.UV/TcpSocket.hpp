@@ -27,6 +27,15 @@ namespace UV
 
         static TcpSocket Create();
 
+        /**
+         * @brief 在当前RunLoop上打开一个现成的套接字
+         * @param fd 系统套接字句柄
+         *
+         * 通常配合Detach使用，用于将连接从一个RunLoop移交到另一个RunLoop。
+         * 若失败，fd的所有权仍归调用方。
+         */
+        static TcpSocket Create(int fd);
+
     private:
         static void OnUVConnect(::uv_connect_s* request, int status)noexcept;
         static void OnUVConnection(::uv_stream_s* handle, int status)noexcept;
@@ -36,6 +45,8 @@ namespace UV
 
     public:
         TcpSocket(TcpSocket&& org)noexcept;
+        ~TcpSocket();
+
         TcpSocket& operator=(TcpSocket&& rhs)noexcept;
 
     public:
@@ -64,6 +75,16 @@ namespace UV
          */
         void SetSimultaneousAccepts(bool enable);
 
+        /**
+         * @brief 设置SO_BUSY_POLL
+         * @param usec 接收队列为空时内核忙轮询网卡的时间（微秒），0表示关闭
+         *
+         * - 仅Linux支持，其他平台抛出InvalidCallException。
+         * - 需要在系统套接字创建后（Bind、Connect或Accept之后）调用，超过net.core.busy_poll的值需要CAP_NET_ADMIN。
+         * - 通常与RunLoop::RunBusyPoll配合使用。
+         */
+        void SetBusyPoll(unsigned usec);
+
         /**
          * @brief 绑定到地址
          * @param addr 地址
@@ -89,6 +110,17 @@ namespace UV
          */
         TcpSocket Accept();
 
+        /**
+         * @brief 从RunLoop上分离套接字
+         * @return 复制后的系统套接字句柄，所有权归调用方
+         *
+         * 方法会复制底层句柄，随后停止读操作并关闭当前对象，连接本身不会断开。
+         * 调用时写队列必须为空，否则抛出异常。
+         * 返回的句柄可以跨线程传递，并在目标RunLoop线程上通过Create(int)重新打开。
+         * Windows下不支持。
+         */
+        int Detach();
+
         /**
          * @brief 获取本地名称
          */
@@ -99,6 +131,22 @@ namespace UV
          */
         EndPoint GetPeerName();
 
+        /**
+         * @brief 发送文件
+         * @param fd 文件描述符，在回调前必须保持有效
+         * @param offset 文件偏移
+         * @param length 发送长度
+         * @param cb 回调函数
+         *
+         * - 数据由内核直接从文件发送到套接字，不经过用户态缓冲区。
+         * - 与Write/WriteNoCopy保持写顺序：之前的写操作完成后才开始发送，之后的写操作会等到文件发送完毕再提交。
+         * - sendfile在libuv线程池中执行，不会因磁盘IO阻塞RunLoop；套接字缓冲区满时等待可写后继续发送。
+         * - 文件长度不足时以UV_EOF回调。
+         * - Windows下不支持。
+         */
+        void SendFile(int fd, uint64_t offset, size_t length, const OnWriteCallbackType& cb);
+        void SendFile(int fd, uint64_t offset, size_t length, OnWriteCallbackType&& cb);
+
     public:
         const OnConnectCallbackType& GetOnConnectCallback()const noexcept { return m_pOnConnect; }
         void SetOnConnectCallback(const OnConnectCallbackType& cb) { m_pOnConnect = cb; }
@@ -113,6 +161,13 @@ namespace UV
         void OnConnection();
 
     private:
+        struct SendFileContext;
+
+        void DetachSendFile()noexcept;
+
+    private:
+        SendFileContext* m_pSendFile = nullptr;  // 正在发送的文件
+
         OnConnectCallbackType m_pOnConnect;
         OnConnectionCallbackType m_pOnConnection;
     };
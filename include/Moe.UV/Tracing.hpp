@@ -0,0 +1,96 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#pragma once
+#include <Moe.Core/Utils.hpp>
+
+#include <atomic>
+#include <string>
+
+namespace moe
+{
+namespace UV
+{
+    /**
+     * @brief 回调追踪
+     *
+     * - 记录所有经由MOE_UV_CATCH_ALL_BEGIN派发的回调（包括线程池中的任务），每个回调产生一个包含开始时间和耗时的事件。
+     * - 事件写入每个线程各自的环形缓冲区，写入无锁，缓冲区满后覆盖最旧的事件。
+     * - 事件名称为回调所在的类型和函数，句柄回调会附带句柄对象的地址作为标识。
+     * - 导出为Chrome Trace格式的JSON，可以在chrome://tracing或Perfetto中查看。
+     * - 未启用时每个回调仅有一次原子变量的读取。
+     */
+    class Tracing
+    {
+    public:
+        /**
+         * @brief 默认每个线程缓冲的事件数
+         */
+        static const size_t kDefaultBufferSize = 64 * 1024;
+
+        /**
+         * @brief 标记当前正在处理的句柄
+         *
+         * 由MOE_UV_GET_SELF自动创建，作用域内的回调事件以该句柄作为标识。
+         */
+        class HandleScope :
+            public NonCopyable
+        {
+        public:
+            explicit HandleScope(const void* handle)noexcept;
+            ~HandleScope();
+
+        private:
+            bool m_bActive = false;
+            const void* m_pPrev = nullptr;
+        };
+
+    public:
+        /**
+         * @brief 是否已启用
+         */
+        static bool IsEnabled()noexcept { return s_bEnabled.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief 启用追踪
+         * @param bufferSize 每个线程缓冲的事件数，仅对之后新建缓冲区的线程生效
+         */
+        static void Start(size_t bufferSize=kDefaultBufferSize);
+
+        /**
+         * @brief 停止追踪
+         *
+         * 已记录的事件会被保留，直到Clear。
+         */
+        static void Stop()noexcept;
+
+        /**
+         * @brief 清空所有线程上已记录的事件
+         *
+         * 不应与正在记录的线程并发调用，否则可能丢失或残留少量事件。
+         */
+        static void Clear()noexcept;
+
+        /**
+         * @brief 导出为Chrome Trace格式
+         * @param[out] out 输出的JSON
+         *
+         * 线程安全，可以在追踪进行中调用，导出期间被覆盖的事件会被丢弃。
+         */
+        static void DumpChromeTrace(std::string& out);
+
+        /**
+         * @brief 记录一个回调事件
+         * @param site 回调所在函数的签名，必须为静态存储期的字符串
+         * @param start 开始时间（纳秒）
+         * @param duration 耗时（纳秒）
+         */
+        static void Record(const char* site, uint64_t start, uint64_t duration)noexcept;
+
+    private:
+        static std::atomic<bool> s_bEnabled;
+    };
+}
+}
@@ -6,8 +6,10 @@
 #pragma once
 #include "AsyncHandle.hpp"
 #include "EndPoint.hpp"
+#include "IoStats.hpp"
 
 #include <functional>
+#include <memory>
 
 // fvck Windows
 #if defined(_MSC_VER) && !defined(_SSIZE_T_) && !defined(_SSIZE_T_DEFINED)
@@ -55,7 +57,7 @@ namespace UV
             unsigned flags)noexcept;
 
     protected:
-        using AsyncHandle::AsyncHandle;
+        UdpSocket(UniquePooledObject<::uv_handle_s>&& handle);
 
     public:
         UdpSocket(UdpSocket&& org)noexcept;
@@ -85,6 +87,16 @@ namespace UV
          */
         void SetTTL(int ttl);
 
+        /**
+         * @brief 设置SO_BUSY_POLL
+         * @param usec 接收队列为空时内核忙轮询网卡的时间（微秒），0表示关闭
+         *
+         * - 仅Linux支持，其他平台抛出InvalidCallException。
+         * - 需要在系统套接字创建后（Bind或首次Send之后）调用，超过net.core.busy_poll的值需要CAP_NET_ADMIN。
+         * - 通常与RunLoop::RunBusyPoll配合使用。
+         */
+        void SetBusyPoll(unsigned usec);
+
         /**
          * @brief 绑定套接字
          * @param address 绑定地址
@@ -137,6 +149,20 @@ namespace UV
          */
         bool TrySend(const EndPoint& address, BytesView buffer);
 
+        /**
+         * @brief 是否启用了I/O计数
+         */
+        bool IsIoStatsEnabled()const noexcept { return m_pIoStats != nullptr; }
+
+        /**
+         * @brief 启用或关闭I/O计数
+         *
+         * 创建时若RunLoop::IsIoStatsEnabledByDefault则自动启用，重新启用时计数从零开始。
+         */
+        void SetIoStatsEnabled(bool enabled);
+
+        const IoStats* GetIoStats()const noexcept override { return m_pIoStats.get(); }
+
     public:
         const OnErrorCallbackType& GetOnErrorCallback()const noexcept { return m_pOnError; }
         void SetOnErrorCallback(const OnErrorCallbackType& cb) { m_pOnError = cb; }
@@ -151,6 +177,11 @@ namespace UV
         void OnData(const EndPoint& remote, BytesView data);
 
     private:
+        void UpdateSendQueueHighWater(::uv_udp_s* handle)noexcept;
+
+    private:
+        std::unique_ptr<IoStats> m_pIoStats;
+
         OnErrorCallbackType m_pOnError;
         OnDataCallbackType m_pOnData;
     };
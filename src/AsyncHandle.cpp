@@ -11,6 +11,16 @@ using namespace std;
 using namespace moe;
 using namespace UV;
 
+namespace
+{
+    void RecordHandleFree(::uv_handle_t* handle)noexcept
+    {
+        auto loop = RunLoop::GetCurrent();
+        if (loop)
+            loop->RecordFree(AllocCategory::Handle, ::uv_handle_size(handle->type));
+    }
+}
+
 void* AsyncHandle::HandleToData(AsyncHandle* data)noexcept
 {
     static const auto kMask = BitCast<size_t>(numeric_limits<ssize_t>::min());
@@ -34,6 +44,7 @@ void AsyncHandle::OnUVClose(::uv_handle_s* handle)noexcept
     if (!self)
     {
         // 所有权已经提前释放
+        RecordHandleFree(handle);
         UniquePooledObject<::uv_handle_s> p(handle);
         return;
     }
@@ -51,6 +62,10 @@ AsyncHandle::AsyncHandle(UniquePooledObject<::uv_handle_s>&& handle)
     assert(m_pHandle);
     GetHandle()->data = HandleToData(this);
     m_bHandleClosed = false;
+
+    auto loop = RunLoop::GetCurrent();
+    if (loop)
+        loop->RecordAlloc(AllocCategory::Handle, ::uv_handle_size(GetHandle()->type));
 }
 
 AsyncHandle::AsyncHandle(AsyncHandle&& org)noexcept
@@ -72,15 +87,26 @@ AsyncHandle::~AsyncHandle()
         auto p = m_pHandle.release();
         p->data = nullptr;
     }
+    else if (m_pHandle)
+        RecordHandleFree(GetHandle());
 }
 
 AsyncHandle& AsyncHandle::operator=(AsyncHandle&& org)noexcept
 {
     if (m_pHandle)
     {
-        Close();
-        GetHandle()->data = nullptr;
-        m_pHandle.release();
+        if (m_bHandleClosed)
+        {
+            // 已经关闭的句柄可以直接释放
+            RecordHandleFree(GetHandle());
+            m_pHandle.reset();
+        }
+        else
+        {
+            Close();
+            GetHandle()->data = nullptr;
+            m_pHandle.release();
+        }
     }
 
     m_pHandle = std::move(org.m_pHandle);
@@ -104,6 +130,19 @@ bool AsyncHandle::IsClosing()const noexcept
     return ret;
 }
 
+const char* AsyncHandle::GetTypeName()const noexcept
+{
+    if (!m_pHandle || m_bHandleClosed)
+        return "unknown";
+    auto ret = ::uv_handle_type_name(GetHandle()->type);
+    return ret ? ret : "unknown";
+}
+
+const IoStats* AsyncHandle::GetIoStats()const noexcept
+{
+    return nullptr;
+}
+
 bool AsyncHandle::Close()noexcept
 {
     if (IsClosing())
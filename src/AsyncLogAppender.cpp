@@ -0,0 +1,286 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include <Moe.UV/AsyncLogAppender.hpp>
+
+#include <ctime>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "UV.inl"
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+
+//////////////////////////////////////////////////////////////////////////////// AsyncLogAppender::State
+
+struct AsyncLogAppender::State
+{
+    File Target;
+    unique_ptr<char[]> Buffer;
+    size_t Capacity = 0;
+    size_t Head = 0;  // 最早一条未写出数据的位置
+    size_t Size = 0;  // 缓冲区中的数据量，包括正在写出的部分
+    size_t Writing = 0;  // 正在写出的数据量
+    bool Detached = false;  // 输出器已经析构
+
+    uint64_t Dropped = 0;
+    uint64_t UnreportedDropped = 0;
+    uint64_t WrittenBytes = 0;
+
+    time_t CachedSecond = 0;
+    char CachedTime[32] = { 0 };
+
+    size_t GetFree()const noexcept { return Capacity - Size; }
+
+    void Push(const char* data, size_t length)noexcept
+    {
+        assert(length <= GetFree());
+
+        auto tail = (Head + Size) % Capacity;
+        auto first = std::min(length, Capacity - tail);
+        ::memcpy(Buffer.get() + tail, data, first);
+        ::memcpy(Buffer.get(), data + first, length - first);
+        Size += length;
+    }
+
+    void Consume(size_t length)noexcept
+    {
+        assert(length <= Size);
+        Head = (Head + length) % Capacity;
+        Size -= length;
+    }
+
+    size_t GetSegments(::uv_buf_t (&out)[2])const noexcept
+    {
+        auto first = std::min(Size, Capacity - Head);
+        out[0] = ::uv_buf_init(Buffer.get() + Head, static_cast<unsigned>(first));
+        if (first == Size)
+            return 1;
+        out[1] = ::uv_buf_init(Buffer.get(), static_cast<unsigned>(Size - first));
+        return 2;
+    }
+
+    size_t FormatHeader(char* out, size_t size, const char* level)noexcept
+    {
+        auto now = chrono::system_clock::now();
+        auto seconds = chrono::system_clock::to_time_t(now);
+        auto ms = chrono::duration_cast<chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+
+        // 同一秒内复用格式化结果
+        if (seconds != CachedSecond || CachedTime[0] == '\0')
+        {
+            struct tm tm;
+#ifdef MOE_WINDOWS
+            ::localtime_s(&tm, &seconds);
+#else
+            ::localtime_r(&seconds, &tm);
+#endif
+            ::strftime(CachedTime, sizeof(CachedTime), "%Y-%m-%d %H:%M:%S", &tm);
+            CachedSecond = seconds;
+        }
+
+        auto ret = ::snprintf(out, size, "[%s.%03d][%s] ", CachedTime, static_cast<int>(ms), level);
+        return ret < 0 ? 0 : std::min(static_cast<size_t>(ret), size - 1);
+    }
+
+    bool TryAppend(const char* level, const char* message, size_t length)noexcept
+    {
+        char header[64];
+        auto headerLength = FormatHeader(header, sizeof(header), level);
+        if (headerLength + length + 1 > GetFree())
+            return false;
+
+        Push(header, headerLength);
+        Push(message, length);
+        Push("\n", 1);
+        return true;
+    }
+
+    void WriteSync()noexcept
+    {
+        // 不依赖RunLoop，直接在当前线程上写出
+        while (Writing == 0 && Size > 0 && Target)
+        {
+            ::uv_buf_t desc[2];
+            auto count = GetSegments(desc);
+
+            ::uv_fs_t req;
+            auto ret = ::uv_fs_write(nullptr, &req, Target.GetFd(), desc, static_cast<unsigned>(count), -1, nullptr);
+            ::uv_fs_req_cleanup(&req);
+            if (ret <= 0)
+            {
+                MOE_LOG_ERROR("Write log error: {0}", ::uv_strerror(static_cast<int>(ret)));
+                break;
+            }
+
+            WrittenBytes += static_cast<size_t>(ret);
+            Consume(static_cast<size_t>(ret));
+        }
+    }
+
+    static void Submit(const shared_ptr<State>& state)noexcept;
+    static void OnWritten(const shared_ptr<State>& state, int status, size_t bytes)noexcept;
+};
+
+void AsyncLogAppender::State::Submit(const shared_ptr<State>& state)noexcept
+{
+    if (state->Writing != 0 || state->Size == 0 || !state->Target)
+        return;
+
+    ::uv_buf_t desc[2];
+    auto count = state->GetSegments(desc);
+
+    vector<BytesView> buffers;
+    try
+    {
+        buffers.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            buffers.emplace_back(reinterpret_cast<const uint8_t*>(desc[i].base), desc[i].len);
+
+        state->Writing = state->Size;
+        state->Target.WriteNoCopy(-1, buffers, [state](int status, size_t bytes) {
+            OnWritten(state, status, bytes);
+        });
+    }
+    catch (const std::exception& ex)
+    {
+        // 无法提交异步请求时退化为同步写出
+        MOE_LOG_ERROR("Submit async log error: {0}", ex.what());
+        state->Writing = 0;
+        state->WriteSync();
+    }
+}
+
+void AsyncLogAppender::State::OnWritten(const shared_ptr<State>& state, int status, size_t bytes)noexcept
+{
+    assert(state->Writing > 0);
+    auto writing = state->Writing;
+    state->Writing = 0;
+
+    if (status < 0)
+    {
+        // 写出失败时丢弃这部分数据，避免反复重试
+        MOE_LOG_ERROR("Write log error: {0}", ::uv_strerror(status));
+        state->Consume(writing);
+    }
+    else
+    {
+        assert(bytes <= writing);
+        state->WrittenBytes += bytes;
+        state->Consume(bytes);
+    }
+
+    if (state->Detached)
+        state->WriteSync();
+    else if (state->Size >= state->Capacity / 4)
+        Submit(state);
+}
+
+//////////////////////////////////////////////////////////////////////////////// AsyncLogAppender
+
+const size_t AsyncLogAppender::kDefaultBufferSize;
+const Time::Tick AsyncLogAppender::kDefaultFlushInterval;
+const size_t AsyncLogAppender::kMaxMessageLength;
+
+thread_local static AsyncLogAppender* t_pAsyncLogAppender = nullptr;
+
+AsyncLogAppender* AsyncLogAppender::GetCurrent()noexcept
+{
+    return t_pAsyncLogAppender;
+}
+
+AsyncLogAppender::AsyncLogAppender(File&& file, size_t bufferSize, Time::Tick flushInterval)
+    : m_pState(make_shared<State>()), m_stFlushTimer(Timer::CreateTickTimer(flushInterval))
+{
+    if (!file)
+        MOE_THROW(BadArgumentException, "Invalid file");
+    if (bufferSize == 0 || flushInterval == 0)
+        MOE_THROW(BadArgumentException, "Buffer size and flush interval must be positive");
+    if (t_pAsyncLogAppender)
+        MOE_THROW(InvalidCallException, "AsyncLogAppender is already created on this thread");
+
+    m_pState->Target = std::move(file);
+    m_pState->Buffer.reset(new char[bufferSize]);
+    m_pState->Capacity = bufferSize;
+
+    // 定时器不应阻止RunLoop退出
+    m_stFlushTimer.SetOnTimeCallback([this]() { Flush(); });
+    m_stFlushTimer.Start();
+    m_stFlushTimer.Unref();
+
+    t_pAsyncLogAppender = this;
+}
+
+AsyncLogAppender::~AsyncLogAppender()
+{
+    assert(t_pAsyncLogAppender == this);
+    t_pAsyncLogAppender = nullptr;
+
+    m_stFlushTimer.Close();
+
+    // 若仍有写请求在进行，剩余数据由其回调同步写出
+    m_pState->Detached = true;
+    m_pState->WriteSync();
+}
+
+uint64_t AsyncLogAppender::GetDroppedCount()const noexcept
+{
+    return m_pState->Dropped;
+}
+
+uint64_t AsyncLogAppender::GetWrittenBytes()const noexcept
+{
+    return m_pState->WrittenBytes;
+}
+
+size_t AsyncLogAppender::GetBufferedSize()const noexcept
+{
+    return m_pState->Size;
+}
+
+bool AsyncLogAppender::Append(const char* level, const char* message, size_t length)noexcept
+{
+    auto& state = *m_pState;
+    length = std::min(length, kMaxMessageLength);
+
+    // 先补写丢弃提示，空间不足时连同本条一起丢弃
+    if (state.UnreportedDropped > 0)
+    {
+        char notice[64];
+        auto noticeLength = ::snprintf(notice, sizeof(notice), "%llu log message(s) dropped",
+            static_cast<unsigned long long>(state.UnreportedDropped));
+        assert(noticeLength > 0);
+        if (!state.TryAppend("WARN", notice, static_cast<size_t>(noticeLength)))
+        {
+            CountDropped();
+            return false;
+        }
+        state.UnreportedDropped = 0;
+    }
+
+    if (!state.TryAppend(level, message, length))
+    {
+        CountDropped();
+        return false;
+    }
+
+    if (state.Size >= state.Capacity / 2)
+        State::Submit(m_pState);
+    return true;
+}
+
+void AsyncLogAppender::Flush()noexcept
+{
+    State::Submit(m_pState);
+}
+
+void AsyncLogAppender::CountDropped()noexcept
+{
+    ++m_pState->Dropped;
+    ++m_pState->UnreportedDropped;
+}
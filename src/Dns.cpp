@@ -14,6 +14,7 @@ using namespace UV;
 struct UVGetAddrInfoReq
 {
     ::uv_getaddrinfo_t Request;
+    AllocAccount Account { AllocCategory::Dns, sizeof(UVGetAddrInfoReq) };
 
     Dns::OnResolveCallbackType OnResolveOne;
     Dns::OnResolveAllCallbackType OnResolveAll;
@@ -107,6 +108,7 @@ struct UVGetAddrInfoReq
 struct UVGetNameInfoReq
 {
     ::uv_getnameinfo_t Request;
+    AllocAccount Account { AllocCategory::Dns, sizeof(UVGetNameInfoReq) };
 
     Dns::OnReverseResolveCallbackType OnReverseResolve;
 
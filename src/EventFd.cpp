@@ -0,0 +1,151 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include <Moe.UV/EventFd.hpp>
+
+#ifdef MOE_LINUX
+
+#include <cerrno>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include "UV.inl"
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+
+EventFd EventFd::Create(bool semaphore)
+{
+    int fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC | (semaphore ? EFD_SEMAPHORE : 0));
+    if (fd < 0)
+        MOE_THROW(ApiException, "eventfd error {0}", errno);
+
+    try
+    {
+        MOE_UV_NEW(::uv_poll_t);
+        MOE_UV_CHECK(::uv_poll_init(GetCurrentUVLoop(), object.get(), fd));
+        return EventFd(fd, CastHandle(std::move(object)));
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+}
+
+void EventFd::OnUVEvent(::uv_poll_t* handle, int status, int events)noexcept
+{
+    MOE_UV_GET_SELF(EventFd);
+    MOE_UNUSED(events);
+
+    if (status < 0)
+    {
+        MOE_UV_LOG_ERROR(status);
+        return;
+    }
+
+    // 读取计数，同时清除可读状态
+    uint64_t count = 0;
+    auto ret = ::read(self->m_iFd, &count, sizeof(count));
+    if (ret != sizeof(count))
+        return;  // 已被其他读取者消耗，属于伪唤醒
+
+    MOE_UV_CATCH_ALL_BEGIN
+        self->OnEvent(count);
+    MOE_UV_CATCH_ALL_END
+}
+
+EventFd::EventFd(int fd, UniquePooledObject<::uv_handle_s>&& handle)
+    : AsyncHandle(std::move(handle)), m_iFd(fd)
+{
+}
+
+EventFd::EventFd(EventFd&& org)noexcept
+    : AsyncHandle(std::move(org)), m_iFd(org.m_iFd), m_pOnEvent(std::move(org.m_pOnEvent))
+{
+    org.m_iFd = -1;
+}
+
+EventFd::~EventFd()
+{
+    // 基类析构时无法派发到派生类的Close，需要在此处释放fd
+    Close();
+    CloseFd();
+}
+
+EventFd& EventFd::operator=(EventFd&& rhs)noexcept
+{
+    AsyncHandle::operator=(std::move(rhs));
+    CloseFd();
+
+    m_iFd = rhs.m_iFd;
+    m_pOnEvent = std::move(rhs.m_pOnEvent);
+
+    rhs.m_iFd = -1;
+    return *this;
+}
+
+void EventFd::Start()
+{
+    MOE_UV_GET_HANDLE(::uv_poll_t);
+    MOE_UV_CHECK(::uv_poll_start(handle, UV_READABLE, OnUVEvent));
+}
+
+void EventFd::Stop()noexcept
+{
+    if (IsClosing())
+        return;
+    MOE_UV_GET_HANDLE_NOTHROW(::uv_poll_t);
+    assert(handle);
+
+    auto ret = ::uv_poll_stop(handle);
+    MOE_UNUSED(ret);
+    assert(ret == 0);
+}
+
+bool EventFd::Notify(uint64_t value)const noexcept
+{
+    assert(value != 0);
+    if (m_iFd < 0)
+        return false;
+
+    // 非阻塞模式下计数溢出返回EAGAIN
+    auto ret = ::write(m_iFd, &value, sizeof(value));
+    return ret == sizeof(value);
+}
+
+bool EventFd::Close()noexcept
+{
+    if (!AsyncHandle::Close())
+        return false;
+
+    // uv_close会同步地将fd从轮询器中移除，此时可以安全关闭
+    CloseFd();
+    return true;
+}
+
+void EventFd::OnClose()
+{
+    CloseFd();
+    AsyncHandle::OnClose();
+}
+
+void EventFd::OnEvent(uint64_t count)
+{
+    if (m_pOnEvent)
+        m_pOnEvent(count);
+}
+
+void EventFd::CloseFd()noexcept
+{
+    if (m_iFd >= 0)
+    {
+        ::close(m_iFd);
+        m_iFd = -1;
+    }
+}
+
+#endif
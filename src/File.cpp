@@ -0,0 +1,729 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include <Moe.UV/File.hpp>
+#include <Moe.UV/ThreadPool.hpp>
+
+#include <deque>
+#include <memory>
+#include <cstring>
+#include <sys/stat.h>
+
+#include "UV.inl"
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+
+namespace
+{
+    uint64_t ToMilliseconds(const ::uv_timespec_t& ts)noexcept
+    {
+        return static_cast<uint64_t>(ts.tv_sec) * 1000u + static_cast<uint64_t>(ts.tv_nsec) / 1000000u;
+    }
+
+    void ToFileStatus(FileStatus& out, const ::uv_stat_t& st)noexcept
+    {
+        out.Device = st.st_dev;
+        out.Mode = st.st_mode;
+        out.LinkCount = st.st_nlink;
+        out.Uid = st.st_uid;
+        out.Gid = st.st_gid;
+        out.Inode = st.st_ino;
+        out.Size = st.st_size;
+        out.BlockSize = st.st_blksize;
+        out.Blocks = st.st_blocks;
+        out.AccessTime = ToMilliseconds(st.st_atim);
+        out.ModifyTime = ToMilliseconds(st.st_mtim);
+        out.ChangeTime = ToMilliseconds(st.st_ctim);
+        out.BirthTime = ToMilliseconds(st.st_birthtim);
+    }
+
+    int ToUVOpenFlags(int flags)noexcept
+    {
+        int ret = 0;
+
+        if ((flags & File::OpenReadWrite) == File::OpenReadWrite)
+            ret |= UV_FS_O_RDWR;
+        else if (flags & File::OpenWrite)
+            ret |= UV_FS_O_WRONLY;
+        else
+            ret |= UV_FS_O_RDONLY;
+
+        if (flags & File::OpenCreate)
+            ret |= UV_FS_O_CREAT;
+        if (flags & File::OpenTruncate)
+            ret |= UV_FS_O_TRUNC;
+        if (flags & File::OpenAppend)
+            ret |= UV_FS_O_APPEND;
+        if (flags & File::OpenExclusive)
+            ret |= UV_FS_O_EXCL;
+        return ret;
+    }
+
+    int64_t ToUVOffset(int64_t offset)noexcept
+    {
+        return offset < 0 ? -1 : offset;
+    }
+}
+
+struct UVFsRequest
+{
+    ::uv_fs_t Request;
+    AllocAccount Account { AllocCategory::Request, sizeof(UVFsRequest) };
+
+    PooledBuffer CopiedBuffer;
+    File::OnOpenCallbackType OnOpen;
+    File::OnReadCallbackType OnTransfer;
+    File::OnCompleteCallbackType OnComplete;
+    File::OnStatCallbackType OnStat;
+
+    UVFsRequest()noexcept
+    {
+        ::memset(&Request, 0, sizeof(Request));
+    }
+
+    ~UVFsRequest()
+    {
+        ::uv_fs_req_cleanup(&Request);
+    }
+
+    static void Callback(::uv_fs_t* req)noexcept
+    {
+        UniquePooledObject<UVFsRequest> self;
+        self.reset(static_cast<UVFsRequest*>(req->data));
+
+        auto status = req->result < 0 ? static_cast<int>(req->result) : 0;
+
+        MOE_UV_CATCH_ALL_BEGIN
+            switch (req->fs_type)
+            {
+                case UV_FS_OPEN:
+                    if (status != 0)
+                        self->OnOpen(static_cast<uv_errno_t>(status), File());
+                    else
+                        self->OnOpen(static_cast<uv_errno_t>(0), File(static_cast<int>(req->result)));
+                    break;
+                case UV_FS_READ:
+                case UV_FS_WRITE:
+                    if (self->OnTransfer)
+                        self->OnTransfer(static_cast<uv_errno_t>(status), status != 0 ? 0 : req->result);
+                    break;
+                case UV_FS_STAT:
+                case UV_FS_FSTAT:
+                    if (status != 0)
+                        self->OnStat(static_cast<uv_errno_t>(status), EmptyRefOf<FileStatus>());
+                    else
+                    {
+                        FileStatus st;
+                        ToFileStatus(st, req->statbuf);
+                        self->OnStat(static_cast<uv_errno_t>(0), st);
+                    }
+                    break;
+                default:
+                    if (self->OnComplete)
+                        self->OnComplete(static_cast<uv_errno_t>(status));
+                    break;
+            }
+        MOE_UV_CATCH_ALL_END
+    }
+};
+
+#define MOVE_OWNER_SELF \
+    do { \
+        auto raw = object.release(); \
+        raw->Request.data = raw; \
+    } while (false)
+
+//////////////////////////////////////////////////////////////////////////////// FileStatus
+
+bool FileStatus::IsRegularFile()const noexcept
+{
+    return (Mode & S_IFMT) == S_IFREG;
+}
+
+bool FileStatus::IsDirectory()const noexcept
+{
+    return (Mode & S_IFMT) == S_IFDIR;
+}
+
+bool FileStatus::IsSymbolicLink()const noexcept
+{
+    return (Mode & S_IFMT) == S_IFLNK;
+}
+
+//////////////////////////////////////////////////////////////////////////////// File
+
+void File::Open(const char* path, int flags, int mode, const OnOpenCallbackType& cb)
+{
+    Open(path, flags, mode, OnOpenCallbackType(cb));
+}
+
+void File::Open(const char* path, int flags, int mode, OnOpenCallbackType&& cb)
+{
+    if (!cb)
+        MOE_THROW(BadArgumentException, "Callback required");
+
+    MOE_UV_NEW(UVFsRequest);
+    object->OnOpen = std::move(cb);
+
+    MOE_UV_CHECK(::uv_fs_open(GetCurrentUVLoop(), &object->Request, path, ToUVOpenFlags(flags), mode,
+        UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+File::File(int fd)noexcept
+    : m_iFd(fd)
+{
+}
+
+File::File(File&& org)noexcept
+    : m_iFd(org.m_iFd)
+{
+    org.m_iFd = -1;
+}
+
+File::~File()
+{
+    if (m_iFd >= 0)
+    {
+        // 同步关闭，不需要RunLoop
+        ::uv_fs_t req;
+        ::uv_fs_close(nullptr, &req, m_iFd, nullptr);
+        ::uv_fs_req_cleanup(&req);
+    }
+}
+
+File& File::operator=(File&& rhs)noexcept
+{
+    File tmp(std::move(*this));
+    m_iFd = rhs.m_iFd;
+    rhs.m_iFd = -1;
+    return *this;
+}
+
+void File::Read(int64_t offset, MutableBytesView buffer, const OnReadCallbackType& cb)
+{
+    Read(offset, buffer, OnReadCallbackType(cb));
+}
+
+void File::Read(int64_t offset, MutableBytesView buffer, OnReadCallbackType&& cb)
+{
+    auto fd = GetFdChecked();
+
+    MOE_UV_NEW(UVFsRequest);
+    object->OnTransfer = std::move(cb);
+
+    auto desc = ::uv_buf_init(reinterpret_cast<char*>(buffer.GetBuffer()), static_cast<unsigned>(buffer.GetSize()));
+    MOE_UV_CHECK(::uv_fs_read(GetCurrentUVLoop(), &object->Request, fd, &desc, 1, ToUVOffset(offset),
+        UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void File::Read(int64_t offset, const std::vector<MutableBytesView>& buffers, const OnReadCallbackType& cb)
+{
+    Read(offset, buffers, OnReadCallbackType(cb));
+}
+
+void File::Read(int64_t offset, const std::vector<MutableBytesView>& buffers, OnReadCallbackType&& cb)
+{
+    auto fd = GetFdChecked();
+    if (buffers.empty())
+        MOE_THROW(BadArgumentException, "Buffers required");
+
+    MOE_UV_NEW(UVFsRequest);
+    object->OnTransfer = std::move(cb);
+
+    // uv_fs_read会复制描述数组
+    vector<::uv_buf_t> desc;
+    desc.reserve(buffers.size());
+    for (const auto& buffer : buffers)
+    {
+        desc.push_back(::uv_buf_init(reinterpret_cast<char*>(buffer.GetBuffer()),
+            static_cast<unsigned>(buffer.GetSize())));
+    }
+
+    MOE_UV_CHECK(::uv_fs_read(GetCurrentUVLoop(), &object->Request, fd, desc.data(),
+        static_cast<unsigned>(desc.size()), ToUVOffset(offset), UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void File::Write(int64_t offset, BytesView data, const OnWriteCallbackType& cb)
+{
+    Write(offset, data, OnWriteCallbackType(cb));
+}
+
+void File::Write(int64_t offset, BytesView data, OnWriteCallbackType&& cb)
+{
+    auto fd = GetFdChecked();
+
+    MOE_UV_NEW(UVFsRequest);
+    MOE_UV_ALLOC(AllocCategory::WriteCopy, std::max<size_t>(data.GetSize(), 1));
+    ::memcpy(buffer.Get(), data.GetBuffer(), data.GetSize());
+
+    object->OnTransfer = std::move(cb);
+    object->CopiedBuffer = std::move(buffer);
+
+    auto desc = ::uv_buf_init(static_cast<char*>(object->CopiedBuffer.Get()), static_cast<unsigned>(data.GetSize()));
+    MOE_UV_CHECK(::uv_fs_write(GetCurrentUVLoop(), &object->Request, fd, &desc, 1, ToUVOffset(offset),
+        UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void File::Write(int64_t offset, const std::vector<BytesView>& buffers, const OnWriteCallbackType& cb)
+{
+    Write(offset, buffers, OnWriteCallbackType(cb));
+}
+
+void File::Write(int64_t offset, const std::vector<BytesView>& buffers, OnWriteCallbackType&& cb)
+{
+    auto fd = GetFdChecked();
+
+    size_t total = 0;
+    for (const auto& buffer : buffers)
+        total += buffer.GetSize();
+
+    MOE_UV_NEW(UVFsRequest);
+    MOE_UV_ALLOC(AllocCategory::WriteCopy, std::max<size_t>(total, 1));
+
+    auto p = static_cast<uint8_t*>(buffer.Get());
+    for (const auto& data : buffers)
+    {
+        ::memcpy(p, data.GetBuffer(), data.GetSize());
+        p += data.GetSize();
+    }
+
+    object->OnTransfer = std::move(cb);
+    object->CopiedBuffer = std::move(buffer);
+
+    auto desc = ::uv_buf_init(static_cast<char*>(object->CopiedBuffer.Get()), static_cast<unsigned>(total));
+    MOE_UV_CHECK(::uv_fs_write(GetCurrentUVLoop(), &object->Request, fd, &desc, 1, ToUVOffset(offset),
+        UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void File::WriteNoCopy(int64_t offset, BytesView buffer, const OnWriteCallbackType& cb)
+{
+    WriteNoCopy(offset, buffer, OnWriteCallbackType(cb));
+}
+
+void File::WriteNoCopy(int64_t offset, BytesView buffer, OnWriteCallbackType&& cb)
+{
+    auto fd = GetFdChecked();
+
+    MOE_UV_NEW(UVFsRequest);
+    object->OnTransfer = std::move(cb);
+
+    auto desc = ::uv_buf_init(const_cast<char*>(reinterpret_cast<const char*>(buffer.GetBuffer())),
+        static_cast<unsigned>(buffer.GetSize()));
+    MOE_UV_CHECK(::uv_fs_write(GetCurrentUVLoop(), &object->Request, fd, &desc, 1, ToUVOffset(offset),
+        UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void File::WriteNoCopy(int64_t offset, const std::vector<BytesView>& buffers, const OnWriteCallbackType& cb)
+{
+    WriteNoCopy(offset, buffers, OnWriteCallbackType(cb));
+}
+
+void File::WriteNoCopy(int64_t offset, const std::vector<BytesView>& buffers, OnWriteCallbackType&& cb)
+{
+    auto fd = GetFdChecked();
+    if (buffers.empty())
+        MOE_THROW(BadArgumentException, "Buffers required");
+
+    MOE_UV_NEW(UVFsRequest);
+    object->OnTransfer = std::move(cb);
+
+    // uv_fs_write会复制描述数组
+    vector<::uv_buf_t> desc;
+    desc.reserve(buffers.size());
+    for (const auto& buffer : buffers)
+    {
+        desc.push_back(::uv_buf_init(const_cast<char*>(reinterpret_cast<const char*>(buffer.GetBuffer())),
+            static_cast<unsigned>(buffer.GetSize())));
+    }
+
+    MOE_UV_CHECK(::uv_fs_write(GetCurrentUVLoop(), &object->Request, fd, desc.data(),
+        static_cast<unsigned>(desc.size()), ToUVOffset(offset), UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void File::Sync(const OnCompleteCallbackType& cb)
+{
+    Sync(OnCompleteCallbackType(cb));
+}
+
+void File::Sync(OnCompleteCallbackType&& cb)
+{
+    auto fd = GetFdChecked();
+
+    MOE_UV_NEW(UVFsRequest);
+    object->OnComplete = std::move(cb);
+
+    MOE_UV_CHECK(::uv_fs_fsync(GetCurrentUVLoop(), &object->Request, fd, UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void File::DataSync(const OnCompleteCallbackType& cb)
+{
+    DataSync(OnCompleteCallbackType(cb));
+}
+
+void File::DataSync(OnCompleteCallbackType&& cb)
+{
+    auto fd = GetFdChecked();
+
+    MOE_UV_NEW(UVFsRequest);
+    object->OnComplete = std::move(cb);
+
+    MOE_UV_CHECK(::uv_fs_fdatasync(GetCurrentUVLoop(), &object->Request, fd, UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void File::Truncate(uint64_t size, const OnCompleteCallbackType& cb)
+{
+    Truncate(size, OnCompleteCallbackType(cb));
+}
+
+void File::Truncate(uint64_t size, OnCompleteCallbackType&& cb)
+{
+    auto fd = GetFdChecked();
+
+    MOE_UV_NEW(UVFsRequest);
+    object->OnComplete = std::move(cb);
+
+    MOE_UV_CHECK(::uv_fs_ftruncate(GetCurrentUVLoop(), &object->Request, fd, static_cast<int64_t>(size),
+        UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void File::Stat(const OnStatCallbackType& cb)
+{
+    Stat(OnStatCallbackType(cb));
+}
+
+void File::Stat(OnStatCallbackType&& cb)
+{
+    auto fd = GetFdChecked();
+    if (!cb)
+        MOE_THROW(BadArgumentException, "Callback required");
+
+    MOE_UV_NEW(UVFsRequest);
+    object->OnStat = std::move(cb);
+
+    MOE_UV_CHECK(::uv_fs_fstat(GetCurrentUVLoop(), &object->Request, fd, UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void File::Close(const OnCompleteCallbackType& cb)
+{
+    Close(OnCompleteCallbackType(cb));
+}
+
+void File::Close(OnCompleteCallbackType&& cb)
+{
+    auto fd = GetFdChecked();
+
+    MOE_UV_NEW(UVFsRequest);
+    object->OnComplete = std::move(cb);
+
+    MOE_UV_CHECK(::uv_fs_close(GetCurrentUVLoop(), &object->Request, fd, UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+
+    m_iFd = -1;
+}
+
+int File::GetFdChecked()const
+{
+    if (m_iFd < 0)
+        MOE_THROW(InvalidCallException, "File is not opened");
+    return m_iFd;
+}
+
+//////////////////////////////////////////////////////////////////////////////// FileSystem
+
+void FileSystem::Stat(const char* path, const OnStatCallbackType& cb)
+{
+    Stat(path, OnStatCallbackType(cb));
+}
+
+void FileSystem::Stat(const char* path, OnStatCallbackType&& cb)
+{
+    if (!cb)
+        MOE_THROW(BadArgumentException, "Callback required");
+
+    MOE_UV_NEW(UVFsRequest);
+    object->OnStat = std::move(cb);
+
+    MOE_UV_CHECK(::uv_fs_stat(GetCurrentUVLoop(), &object->Request, path, UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void FileSystem::Unlink(const char* path, const OnCompleteCallbackType& cb)
+{
+    Unlink(path, OnCompleteCallbackType(cb));
+}
+
+void FileSystem::Unlink(const char* path, OnCompleteCallbackType&& cb)
+{
+    MOE_UV_NEW(UVFsRequest);
+    object->OnComplete = std::move(cb);
+
+    MOE_UV_CHECK(::uv_fs_unlink(GetCurrentUVLoop(), &object->Request, path, UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void FileSystem::Rename(const char* path, const char* newPath, const OnCompleteCallbackType& cb)
+{
+    Rename(path, newPath, OnCompleteCallbackType(cb));
+}
+
+void FileSystem::Rename(const char* path, const char* newPath, OnCompleteCallbackType&& cb)
+{
+    MOE_UV_NEW(UVFsRequest);
+    object->OnComplete = std::move(cb);
+
+    MOE_UV_CHECK(::uv_fs_rename(GetCurrentUVLoop(), &object->Request, path, newPath, UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void FileSystem::MakeDir(const char* path, int mode, const OnCompleteCallbackType& cb)
+{
+    MakeDir(path, mode, OnCompleteCallbackType(cb));
+}
+
+void FileSystem::MakeDir(const char* path, int mode, OnCompleteCallbackType&& cb)
+{
+    MOE_UV_NEW(UVFsRequest);
+    object->OnComplete = std::move(cb);
+
+    MOE_UV_CHECK(::uv_fs_mkdir(GetCurrentUVLoop(), &object->Request, path, mode, UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+void FileSystem::RemoveDir(const char* path, const OnCompleteCallbackType& cb)
+{
+    RemoveDir(path, OnCompleteCallbackType(cb));
+}
+
+void FileSystem::RemoveDir(const char* path, OnCompleteCallbackType&& cb)
+{
+    MOE_UV_NEW(UVFsRequest);
+    object->OnComplete = std::move(cb);
+
+    MOE_UV_CHECK(::uv_fs_rmdir(GetCurrentUVLoop(), &object->Request, path, UVFsRequest::Callback));
+    MOVE_OWNER_SELF;
+}
+
+//////////////////////////////////////////////////////////////////////////////// FileSystem::Scan
+
+const size_t FileSystem::kDefaultScanConcurrency;
+const size_t FileSystem::kScanBatchSize;
+
+namespace
+{
+    struct ScanContext
+    {
+        FileSystem::OnScanFilterCallbackType Filter;  // 工作线程只读
+        FileSystem::OnScanBatchCallbackType OnBatch;
+        FileSystem::OnCompleteCallbackType OnComplete;
+        size_t Concurrency = 0;
+
+        deque<string> Directories;
+        size_t InFlight = 0;
+        int Status = 0;
+        vector<FileSystem::ScanEntry> Batch;
+
+        void SetError(int status)noexcept
+        {
+            if (Status == 0 && status < 0)
+                Status = status;
+        }
+    };
+
+    struct ScanResult
+    {
+        string Directory;
+        int Status = 0;
+        vector<FileSystem::ScanEntry> Entries;
+        vector<string> Subdirectories;
+    };
+
+    string JoinPath(const string& directory, const char* name)
+    {
+        string ret;
+        ret.reserve(directory.size() + 1 + ::strlen(name));
+        ret.append(directory);
+        if (!directory.empty() && directory.back() != '/')
+            ret.push_back('/');
+        ret.append(name);
+        return ret;
+    }
+
+    void ScanDirectory(const FileSystem::OnScanFilterCallbackType& filter, ScanResult& result)
+    {
+        ::uv_fs_t req;
+        auto ret = ::uv_fs_scandir(nullptr, &req, result.Directory.c_str(), 0, nullptr);
+        if (ret < 0)
+        {
+            ::uv_fs_req_cleanup(&req);
+            result.Status = ret;
+            return;
+        }
+
+        try
+        {
+            ::uv_dirent_t ent;
+            while (::uv_fs_scandir_next(&req, &ent) != UV_EOF)
+            {
+                FileSystem::ScanEntry entry;
+                entry.Path = JoinPath(result.Directory, ent.name);
+
+                // 类型已知时先过滤，省去被过滤条目的lstat
+                auto filtered = false;
+                if (filter && ent.type != UV_DIRENT_UNKNOWN)
+                {
+                    if (!filter(entry.Path, ent.type == UV_DIRENT_DIR))
+                        continue;
+                    filtered = true;
+                }
+
+                ::uv_fs_t st;
+                auto status = ::uv_fs_lstat(nullptr, &st, entry.Path.c_str(), nullptr);
+                if (status == 0)
+                    ToFileStatus(entry.Status, st.statbuf);
+                ::uv_fs_req_cleanup(&st);
+
+                if (status < 0)
+                {
+                    // 扫描期间被删除的条目直接忽略
+                    if (status != UV_ENOENT && result.Status == 0)
+                        result.Status = status;
+                    continue;
+                }
+
+                auto isDirectory = entry.Status.IsDirectory();
+                if (filter && !filtered && !filter(entry.Path, isDirectory))
+                    continue;
+
+                if (isDirectory)
+                    result.Subdirectories.push_back(entry.Path);
+                result.Entries.emplace_back(std::move(entry));
+            }
+        }
+        catch (...)
+        {
+            ::uv_fs_req_cleanup(&req);
+            result.Status = UV_ECANCELED;
+            throw;
+        }
+        ::uv_fs_req_cleanup(&req);
+    }
+
+    void DeliverScanBatch(const shared_ptr<ScanContext>& context)noexcept
+    {
+        if (context->Batch.empty())
+            return;
+
+        auto batch = std::move(context->Batch);
+        context->Batch.clear();
+
+        MOE_UV_CATCH_ALL_BEGIN
+            if (context->OnBatch)
+                context->OnBatch(batch);
+        MOE_UV_CATCH_ALL_END
+    }
+
+    void OnDirectoryScanned(const shared_ptr<ScanContext>& context, int status, ScanResult& result)noexcept;
+
+    void PumpScan(const shared_ptr<ScanContext>& context)
+    {
+        while (context->InFlight < context->Concurrency && !context->Directories.empty())
+        {
+            auto result = make_shared<ScanResult>();
+            result->Directory = std::move(context->Directories.front());
+            context->Directories.pop_front();
+
+            ++context->InFlight;
+            try
+            {
+                ThreadPool::QueueWork(
+                    [context, result](void*) {
+                        ScanDirectory(context->Filter, *result);
+                    },
+                    [context, result](int status, void*) {
+                        OnDirectoryScanned(context, status, *result);
+                    });
+            }
+            catch (...)
+            {
+                --context->InFlight;
+                throw;
+            }
+        }
+    }
+
+    void OnDirectoryScanned(const shared_ptr<ScanContext>& context, int status, ScanResult& result)noexcept
+    {
+        assert(context->InFlight > 0);
+        --context->InFlight;
+        context->SetError(status);
+        context->SetError(result.Status);
+
+        try
+        {
+            for (auto& directory : result.Subdirectories)
+                context->Directories.emplace_back(std::move(directory));
+
+            if (context->Batch.empty())
+                context->Batch = std::move(result.Entries);
+            else
+            {
+                context->Batch.insert(context->Batch.end(), std::make_move_iterator(result.Entries.begin()),
+                    std::make_move_iterator(result.Entries.end()));
+            }
+
+            // 先派发新的任务，使工作线程在回调执行期间保持忙碌
+            PumpScan(context);
+        }
+        catch (const std::exception& ex)
+        {
+            MOE_UV_ASYNC_LOG_ERROR("Scan directory error: {0}", ex.what());
+            context->SetError(UV_ENOMEM);
+            context->Directories.clear();
+        }
+
+        if (context->Batch.size() >= FileSystem::kScanBatchSize)
+            DeliverScanBatch(context);
+
+        if (context->InFlight == 0 && context->Directories.empty())
+        {
+            DeliverScanBatch(context);
+
+            auto cb = std::move(context->OnComplete);
+            MOE_UV_CATCH_ALL_BEGIN
+                if (cb)
+                    cb(context->Status);
+            MOE_UV_CATCH_ALL_END
+        }
+    }
+}
+
+void FileSystem::Scan(const char* root, const OnScanFilterCallbackType& filter, const OnScanBatchCallbackType& onBatch,
+    const OnCompleteCallbackType& onComplete, size_t concurrency)
+{
+    if (concurrency == 0)
+        MOE_THROW(BadArgumentException, "Concurrency must be positive");
+
+    auto context = make_shared<ScanContext>();
+    context->Filter = filter;
+    context->OnBatch = onBatch;
+    context->OnComplete = onComplete;
+    context->Concurrency = concurrency;
+    context->Directories.emplace_back(root);
+
+    PumpScan(context);
+}
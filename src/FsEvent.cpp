@@ -59,6 +59,15 @@ void FsEvent::Start(const char* path, unsigned int flags)
     MOE_UV_CHECK(::uv_fs_event_start(handle, OnUVEvent, path, flags));
 }
 
+int FsEvent::TryStart(const char* path, unsigned int flags)noexcept
+{
+    if (IsClosing())
+        return UV_EINVAL;
+    MOE_UV_GET_HANDLE_NOTHROW(::uv_fs_event_t);
+    assert(handle);
+    return ::uv_fs_event_start(handle, OnUVEvent, path, flags);
+}
+
 bool FsEvent::Stop()noexcept
 {
     if (IsClosing())
@@ -0,0 +1,202 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include <Moe.UV/HighResolutionTimer.hpp>
+
+#ifdef MOE_LINUX
+
+#include <cerrno>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#include "UV.inl"
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+
+namespace
+{
+    const uint64_t kNanosPerSecond = 1000000000ull;
+
+    ::timespec ToTimeSpec(uint64_t ns)noexcept
+    {
+        ::timespec ret;
+        ret.tv_sec = static_cast<time_t>(ns / kNanosPerSecond);
+        ret.tv_nsec = static_cast<long>(ns % kNanosPerSecond);
+        return ret;
+    }
+}
+
+HighResolutionTimer HighResolutionTimer::Create()
+{
+    int fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0)
+        MOE_THROW(ApiException, "timerfd_create error {0}", errno);
+
+    try
+    {
+        MOE_UV_NEW(::uv_poll_t);
+        MOE_UV_CHECK(::uv_poll_init(GetCurrentUVLoop(), object.get(), fd));
+        return HighResolutionTimer(fd, CastHandle(std::move(object)));
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+}
+
+HighResolutionTimer HighResolutionTimer::CreateTickTimer(uint64_t intervalNs)
+{
+    auto ret = Create();
+    ret.SetFirstTime(intervalNs);
+    ret.SetInterval(intervalNs);
+    return ret;
+}
+
+void HighResolutionTimer::OnUVEvent(::uv_poll_t* handle, int status, int events)noexcept
+{
+    MOE_UV_GET_SELF(HighResolutionTimer);
+    MOE_UNUSED(events);
+
+    if (status < 0)
+    {
+        MOE_UV_LOG_ERROR(status);
+        return;
+    }
+
+    // 读取超时次数，同时清除可读状态
+    uint64_t expirations = 0;
+    auto ret = ::read(self->m_iFd, &expirations, sizeof(expirations));
+    if (ret != sizeof(expirations))
+        return;  // 计时器在回调前被重置，属于伪唤醒
+
+    self->m_ullLastExpirations = expirations;
+
+    MOE_UV_CATCH_ALL_BEGIN
+        self->OnTime();
+    MOE_UV_CATCH_ALL_END
+}
+
+HighResolutionTimer::HighResolutionTimer(int fd, UniquePooledObject<::uv_handle_s>&& handle)
+    : AsyncHandle(std::move(handle)), m_iFd(fd)
+{
+}
+
+HighResolutionTimer::HighResolutionTimer(HighResolutionTimer&& org)noexcept
+    : AsyncHandle(std::move(org)), m_iFd(org.m_iFd), m_ullFirstTime(org.m_ullFirstTime),
+    m_ullInterval(org.m_ullInterval), m_ullLastExpirations(org.m_ullLastExpirations),
+    m_stOnTime(std::move(org.m_stOnTime))
+{
+    org.m_iFd = -1;
+}
+
+HighResolutionTimer::~HighResolutionTimer()
+{
+    // 基类析构时无法派发到派生类的Close，需要在此处释放fd
+    Close();
+    CloseFd();
+}
+
+HighResolutionTimer& HighResolutionTimer::operator=(HighResolutionTimer&& rhs)noexcept
+{
+    AsyncHandle::operator=(std::move(rhs));
+    CloseFd();
+
+    m_iFd = rhs.m_iFd;
+    m_ullFirstTime = rhs.m_ullFirstTime;
+    m_ullInterval = rhs.m_ullInterval;
+    m_ullLastExpirations = rhs.m_ullLastExpirations;
+    m_stOnTime = std::move(rhs.m_stOnTime);
+
+    rhs.m_iFd = -1;
+    return *this;
+}
+
+bool HighResolutionTimer::Start()
+{
+    if (IsClosing())
+        return false;
+
+    // it_value为0表示解除计时器，因此至少延迟1ns
+    Arm(std::max<uint64_t>(m_ullFirstTime, 1), m_ullInterval, false);
+    return true;
+}
+
+bool HighResolutionTimer::StartAt(uint64_t deadline)
+{
+    if (IsClosing())
+        return false;
+
+    Arm(std::max<uint64_t>(deadline, 1), m_ullInterval, true);
+    return true;
+}
+
+void HighResolutionTimer::Stop()noexcept
+{
+    if (IsClosing())
+        return;
+    MOE_UV_GET_HANDLE_NOTHROW(::uv_poll_t);
+    assert(handle);
+
+    ::itimerspec spec;
+    ::memset(&spec, 0, sizeof(spec));
+
+    // 理论上总是成功的
+    auto ret = ::timerfd_settime(m_iFd, 0, &spec, nullptr);
+    MOE_UNUSED(ret);
+    assert(ret == 0);
+
+    ret = ::uv_poll_stop(handle);
+    assert(ret == 0);
+}
+
+bool HighResolutionTimer::Close()noexcept
+{
+    if (!AsyncHandle::Close())
+        return false;
+
+    // uv_close会同步地将fd从轮询器中移除，此时可以安全关闭
+    CloseFd();
+    return true;
+}
+
+void HighResolutionTimer::OnClose()
+{
+    CloseFd();
+    AsyncHandle::OnClose();
+}
+
+void HighResolutionTimer::OnTime()
+{
+    if (m_stOnTime)
+        m_stOnTime();
+}
+
+void HighResolutionTimer::Arm(uint64_t first, uint64_t interval, bool absolute)
+{
+    MOE_UV_GET_HANDLE(::uv_poll_t);
+
+    ::itimerspec spec;
+    spec.it_value = ToTimeSpec(first);
+    spec.it_interval = ToTimeSpec(interval);
+    if (::timerfd_settime(m_iFd, absolute ? TFD_TIMER_ABSTIME : 0, &spec, nullptr) != 0)
+        MOE_THROW(ApiException, "timerfd_settime error {0}", errno);
+
+    MOE_UV_CHECK(::uv_poll_start(handle, UV_READABLE, OnUVEvent));
+}
+
+void HighResolutionTimer::CloseFd()noexcept
+{
+    if (m_iFd >= 0)
+    {
+        ::close(m_iFd);
+        m_iFd = -1;
+    }
+}
+
+#endif
@@ -0,0 +1,242 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include <Moe.UV/LoopWatchdog.hpp>
+
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+
+#if defined(MOE_LINUX) && defined(__GLIBC__)
+#define MOE_UV_WATCHDOG_STACK_CAPTURE
+#include <execinfo.h>
+#endif
+
+#include "UV.inl"
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+
+#ifdef MOE_UV_WATCHDOG_STACK_CAPTURE
+namespace
+{
+    const int kMaxFrames = 64;
+
+    enum
+    {
+        CAPTURE_IDLE = 0,
+        CAPTURE_REQUESTED,
+        CAPTURE_RUNNING,
+        CAPTURE_DONE,
+    };
+
+    // 同一时刻只有一个看门狗在获取调用栈
+    mutex g_stCaptureMutex;
+    atomic<int> g_iCaptureState(CAPTURE_IDLE);
+    void* g_apFrames[kMaxFrames];
+    int g_iFrameCount = 0;
+
+    void OnCaptureSignal(int)
+    {
+        // 只响应看门狗发起的请求
+        auto expected = static_cast<int>(CAPTURE_REQUESTED);
+        if (!g_iCaptureState.compare_exchange_strong(expected, CAPTURE_RUNNING))
+            return;
+
+        auto savedErrno = errno;
+        g_iFrameCount = ::backtrace(g_apFrames, kMaxFrames);
+        g_iCaptureState.store(CAPTURE_DONE, memory_order_release);
+        errno = savedErrno;
+    }
+}
+#endif
+
+const Time::Tick LoopWatchdog::kDefaultThreshold;
+const Time::Tick LoopWatchdog::kStackCaptureTimeout;
+
+LoopWatchdog::LoopWatchdog(Time::Tick threshold, int stackCaptureSignal)
+    : m_pLoop(RunLoop::GetCurrent()), m_ullThreshold(threshold), m_iSignal(stackCaptureSignal), m_ullStallCount(0)
+{
+    if (!m_pLoop)
+        MOE_THROW(InvalidCallException, "RunLoop required");
+    if (threshold == 0)
+        MOE_THROW(BadArgumentException, "Threshold must be positive");
+
+#ifdef MOE_UV_WATCHDOG_STACK_CAPTURE
+    m_stLoopThread = ::pthread_self();
+    if (m_iSignal != 0)
+    {
+        // 首次调用backtrace会加载libgcc，不能发生在信号处理函数中
+        void* frame = nullptr;
+        ::backtrace(&frame, 1);
+
+        struct sigaction action;
+        ::memset(&action, 0, sizeof(action));
+        action.sa_handler = OnCaptureSignal;
+        action.sa_flags = SA_RESTART;
+        ::sigemptyset(&action.sa_mask);
+        if (::sigaction(m_iSignal, &action, nullptr) != 0)
+            MOE_THROW(ApiException, "sigaction error {0}", errno);
+    }
+#else
+    m_iSignal = 0;
+#endif
+
+    m_pLoop->SetActivityTrackingEnabled(true);
+    try
+    {
+        m_stThread = thread([this]() { ThreadMain(); });
+    }
+    catch (...)
+    {
+        m_pLoop->SetActivityTrackingEnabled(false);
+        throw;
+    }
+}
+
+LoopWatchdog::~LoopWatchdog()
+{
+    {
+        lock_guard<mutex> lock(m_stMutex);
+        m_bStopping = true;
+    }
+    m_stCondVar.notify_one();
+    m_stThread.join();
+
+    m_pLoop->SetActivityTrackingEnabled(false);
+}
+
+void LoopWatchdog::SetOnStallCallback(const OnStallCallbackType& cb)
+{
+    SetOnStallCallback(OnStallCallbackType(cb));
+}
+
+void LoopWatchdog::SetOnStallCallback(OnStallCallbackType&& cb)
+{
+    lock_guard<mutex> lock(m_stMutex);
+    m_pOnStall = std::move(cb);
+}
+
+void LoopWatchdog::OnStall(const StallInfo& info)
+{
+    OnStallCallbackType cb;
+    {
+        lock_guard<mutex> lock(m_stMutex);
+        cb = m_pOnStall;
+    }
+
+    if (cb)
+    {
+        cb(info);
+        return;
+    }
+
+    string stack;
+    for (const auto& frame : info.Stack)
+    {
+        stack.append("\n  ");
+        stack.append(frame);
+    }
+    MOE_LOG_ERROR("RunLoop stalled for {0}ms in {1}{2}", info.Duration, info.Callback ? info.Callback : "<unknown>",
+        stack);
+}
+
+void LoopWatchdog::ThreadMain()noexcept
+{
+    // 以阈值的1/4为周期采样，检测延迟不超过阈值的1.25倍
+    auto interval = chrono::milliseconds(std::max<Time::Tick>(m_ullThreshold / 4, 1));
+    uint64_t reportedSince = 0;
+
+    unique_lock<mutex> lock(m_stMutex);
+    while (!m_bStopping)
+    {
+        m_stCondVar.wait_for(lock, interval);
+        if (m_bStopping)
+            break;
+
+        auto since = m_pLoop->GetBusySince();
+        if (since == 0 || since == reportedSince)
+            continue;
+
+        auto now = RunLoop::NowNanos();
+        if (now <= since || (now - since) / 1000000 < m_ullThreshold)
+            continue;
+
+        reportedSince = since;
+        m_ullStallCount.fetch_add(1, memory_order_relaxed);
+
+        lock.unlock();
+        try
+        {
+            StallInfo info;
+            info.Duration = (now - since) / 1000000;
+            info.Callback = m_pLoop->GetCurrentCallback();
+            CaptureStack(info.Stack);
+            OnStall(info);
+        }
+        catch (const std::exception& ex)
+        {
+            MOE_LOG_ERROR("Uncaught exception in watchdog, desc: {0}", ex.what());
+        }
+        catch (...)
+        {
+            MOE_LOG_ERROR("Uncaught unknown exception in watchdog");
+        }
+        lock.lock();
+    }
+}
+
+void LoopWatchdog::CaptureStack(std::vector<std::string>& out)noexcept
+{
+#ifdef MOE_UV_WATCHDOG_STACK_CAPTURE
+    if (m_iSignal == 0)
+        return;
+
+    lock_guard<mutex> lock(g_stCaptureMutex);
+    g_iCaptureState.store(CAPTURE_REQUESTED, memory_order_release);
+    if (::pthread_kill(m_stLoopThread, m_iSignal) != 0)
+    {
+        g_iCaptureState.store(CAPTURE_IDLE, memory_order_relaxed);
+        return;
+    }
+
+    // RunLoop线程可能屏蔽了信号，超时后撤回请求
+    auto deadline = chrono::steady_clock::now() + chrono::milliseconds(kStackCaptureTimeout);
+    while (g_iCaptureState.load(memory_order_acquire) != CAPTURE_DONE)
+    {
+        if (chrono::steady_clock::now() >= deadline)
+        {
+            auto expected = static_cast<int>(CAPTURE_REQUESTED);
+            if (g_iCaptureState.compare_exchange_strong(expected, CAPTURE_IDLE))
+                return;
+        }
+        this_thread::sleep_for(chrono::microseconds(100));
+    }
+
+    auto count = g_iFrameCount;
+    g_iCaptureState.store(CAPTURE_IDLE, memory_order_relaxed);
+
+    auto symbols = ::backtrace_symbols(g_apFrames, count);
+    if (!symbols)
+        return;
+
+    try
+    {
+        // 第一帧为信号处理函数自身
+        for (int i = 1; i < count; ++i)
+            out.emplace_back(symbols[i]);
+    }
+    catch (...)
+    {
+        out.clear();
+    }
+    ::free(symbols);
+#else
+    MOE_UNUSED(out);
+#endif
+}
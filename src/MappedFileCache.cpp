@@ -0,0 +1,398 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include <Moe.UV/MappedFileCache.hpp>
+#include <Moe.UV/ThreadPool.hpp>
+
+#include <cstdlib>
+#include <sys/stat.h>
+
+#ifndef MOE_WINDOWS
+#include <sys/mman.h>
+#endif
+
+#include "UV.inl"
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+
+//////////////////////////////////////////////////////////////////////////////// MappedFile
+
+int MappedFile::Open(const char* path, std::shared_ptr<MappedFile>& out)noexcept
+{
+    ::uv_fs_t req;
+
+    auto fd = ::uv_fs_open(nullptr, &req, path, UV_FS_O_RDONLY, 0, nullptr);
+    ::uv_fs_req_cleanup(&req);
+    if (fd < 0)
+        return fd;
+
+    auto closeFile = [&]() {
+        ::uv_fs_close(nullptr, &req, fd, nullptr);
+        ::uv_fs_req_cleanup(&req);
+    };
+
+    auto status = ::uv_fs_fstat(nullptr, &req, fd, nullptr);
+    auto mode = req.statbuf.st_mode;
+    auto size = static_cast<size_t>(req.statbuf.st_size);
+    ::uv_fs_req_cleanup(&req);
+    if (status < 0)
+    {
+        closeFile();
+        return status;
+    }
+    if ((mode & S_IFMT) != S_IFREG)
+    {
+        closeFile();
+        return UV_EINVAL;
+    }
+
+    void* data = nullptr;
+    bool mapped = false;
+    if (size > 0)
+    {
+#ifndef MOE_WINDOWS
+        data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            status = -errno;
+            closeFile();
+            return status;
+        }
+        mapped = true;
+        ::madvise(data, size, MADV_WILLNEED);
+#else
+        data = ::malloc(size);
+        if (!data)
+        {
+            closeFile();
+            return UV_ENOMEM;
+        }
+
+        size_t offset = 0;
+        while (offset < size)
+        {
+            auto desc = ::uv_buf_init(static_cast<char*>(data) + offset, static_cast<unsigned>(size - offset));
+            auto count = ::uv_fs_read(nullptr, &req, fd, &desc, 1, static_cast<int64_t>(offset), nullptr);
+            ::uv_fs_req_cleanup(&req);
+            if (count <= 0)
+            {
+                ::free(data);
+                closeFile();
+                return count < 0 ? count : UV_EOF;
+            }
+            offset += static_cast<size_t>(count);
+        }
+#endif
+    }
+
+    // 映射建立后文件描述符不再需要
+    closeFile();
+
+    try
+    {
+        out.reset(new MappedFile(data, size, mapped));
+    }
+    catch (...)
+    {
+        MappedFile tmp(data, size, mapped);
+        return UV_ENOMEM;
+    }
+    return 0;
+}
+
+MappedFile::~MappedFile()
+{
+    if (!m_pData)
+        return;
+
+#ifndef MOE_WINDOWS
+    assert(m_bMapped);
+    ::munmap(m_pData, m_uSize);
+#else
+    assert(!m_bMapped);
+    ::free(m_pData);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////// MappedFileCache
+
+const size_t MappedFileCache::kDefaultMaxBytes;
+
+size_t MappedFileCache::GetDirectoryPrefixLength(const std::string& path)noexcept
+{
+#ifdef MOE_WINDOWS
+    auto pos = path.find_last_of("/\\");
+#else
+    auto pos = path.find_last_of('/');
+#endif
+    return pos == string::npos ? 0 : pos + 1;
+}
+
+MappedFileCache::MappedFileCache(size_t maxBytes)
+    : m_pSelf(make_shared<MappedFileCache*>(this)), m_uMaxBytes(maxBytes)
+{
+}
+
+MappedFileCache::~MappedFileCache()
+{
+    *m_pSelf = nullptr;
+}
+
+MappedFileCache::ContentPtr MappedFileCache::Find(const std::string& path)noexcept
+{
+    auto it = m_stEntries.find(path);
+    if (it == m_stEntries.end())
+    {
+        ++m_ullMissCount;
+        return nullptr;
+    }
+
+    ++m_ullHitCount;
+    m_stLru.splice(m_stLru.begin(), m_stLru, it->second.LruIterator);
+    return it->second.Content;
+}
+
+void MappedFileCache::Load(const std::string& path, const OnLoadCallbackType& cb)
+{
+    Load(path, OnLoadCallbackType(cb));
+}
+
+void MappedFileCache::Load(const std::string& path, OnLoadCallbackType&& cb)
+{
+    auto it = m_stPending.find(path);
+    if (it != m_stPending.end())
+    {
+        it->second.Callbacks.emplace_back(std::move(cb));
+        return;
+    }
+
+    struct LoadResult
+    {
+        string Path;
+        int Status = 0;
+        shared_ptr<MappedFile> Content;
+    };
+
+    auto result = make_shared<LoadResult>();
+    result->Path = path;
+
+    // 先建立监控，避免漏掉加载期间发生的变化，失败时错误同样经由线程池异步回调
+    DirectoryWatcher* watcher = nullptr;
+    result->Status = Watch(path, watcher);
+
+    auto self = m_pSelf;
+    try
+    {
+        ThreadPool::QueueWork(
+            [result](void*) {
+                if (result->Status == 0)
+                    result->Status = MappedFile::Open(result->Path.c_str(), result->Content);
+            },
+            [self, result](int status, void*) {
+                if (*self)
+                    (*self)->OnLoaded(result->Path, status < 0 ? status : result->Status, result->Content);
+            });
+    }
+    catch (...)
+    {
+        if (watcher)
+            Unwatch(watcher);
+        throw;
+    }
+
+    auto& pending = m_stPending[path];
+    pending.Watcher = watcher;
+    pending.Callbacks.emplace_back(std::move(cb));
+}
+
+void MappedFileCache::Invalidate(const std::string& path)noexcept
+{
+    auto it = m_stEntries.find(path);
+    if (it != m_stEntries.end())
+        Erase(it);
+
+    auto jt = m_stPending.find(path);
+    if (jt != m_stPending.end())
+        jt->second.Stale = true;
+}
+
+void MappedFileCache::Clear()noexcept
+{
+    for (auto& pending : m_stPending)
+        pending.second.Stale = true;
+
+    while (!m_stEntries.empty())
+        Erase(m_stEntries.begin());
+    assert(m_stLru.empty() && m_uTotalBytes == 0);
+
+    PurgeWatchers();
+}
+
+int MappedFileCache::Watch(const std::string& path, DirectoryWatcher*& out)
+{
+    PurgeWatchers();
+
+    auto prefixLength = GetDirectoryPrefixLength(path);
+    auto prefix = path.substr(0, prefixLength);
+    auto it = m_stWatchers.find(prefix);
+    if (it == m_stWatchers.end())
+    {
+        auto handle = FsEvent::Create([this, prefix](const char* filename, int events, int status) {
+            MOE_UNUSED(events);
+            OnDirectoryEvent(prefix, filename, status);
+        });
+        auto status = handle.TryStart(prefix.empty() ? "." : prefix.c_str());
+        if (status < 0)
+            return status;
+        it = m_stWatchers.emplace(prefix, DirectoryWatcher(std::move(handle))).first;
+    }
+
+    ++it->second.Refs;
+    out = &it->second;
+    return 0;
+}
+
+void MappedFileCache::Unwatch(DirectoryWatcher* watcher)noexcept
+{
+    assert(watcher->Refs > 0);
+    if (--watcher->Refs != 0)
+        return;
+
+    // 可能处于该监控自身的回调中，只关闭句柄，留待下次Watch或Clear时移除
+    watcher->Handle.Close();
+    ++m_uClosedWatchers;
+}
+
+void MappedFileCache::PurgeWatchers()noexcept
+{
+    if (m_uClosedWatchers == 0)
+        return;
+
+    for (auto it = m_stWatchers.begin(); it != m_stWatchers.end();)
+    {
+        if (it->second.Refs == 0)
+            it = m_stWatchers.erase(it);
+        else
+            ++it;
+    }
+    m_uClosedWatchers = 0;
+}
+
+void MappedFileCache::OnDirectoryEvent(const std::string& prefix, const char* filename, int status)noexcept
+{
+    // 此处在FsEvent回调中，不能销毁监控对象本身
+    if (status == 0 && filename)
+    {
+        try
+        {
+            Invalidate(prefix + filename);
+            return;
+        }
+        catch (const std::bad_alloc&)
+        {
+        }
+    }
+
+    // 无法确定具体文件时使整个目录失效
+    auto matches = [&](const string& path) {
+        return path.size() > prefix.size() && path.compare(0, prefix.size(), prefix) == 0 &&
+            GetDirectoryPrefixLength(path) == prefix.size();
+    };
+
+    for (auto it = m_stEntries.begin(); it != m_stEntries.end();)
+    {
+        auto next = std::next(it);
+        if (matches(it->first))
+            Erase(it);
+        it = next;
+    }
+
+    for (auto& pending : m_stPending)
+    {
+        if (matches(pending.first))
+            pending.second.Stale = true;
+    }
+}
+
+void MappedFileCache::OnLoaded(const std::string& path, int status, const std::shared_ptr<MappedFile>& content)noexcept
+{
+    auto it = m_stPending.find(path);
+    assert(it != m_stPending.end());
+    auto pending = std::move(it->second);
+    m_stPending.erase(it);
+
+    ContentPtr ret;
+    if (status == 0)
+    {
+        ret = content;
+        if (!pending.Stale)
+        {
+            MOE_UV_CATCH_ALL_BEGIN
+                Insert(path, ret, pending.Watcher);
+            MOE_UV_CATCH_ALL_END
+        }
+    }
+
+    // 缓存条目持有自己的引用，加载的引用在回调前释放
+    if (pending.Watcher)
+        Unwatch(pending.Watcher);
+
+    for (auto& cb : pending.Callbacks)
+    {
+        MOE_UV_CATCH_ALL_BEGIN
+            if (cb)
+                cb(status, ret);
+        MOE_UV_CATCH_ALL_END
+    }
+}
+
+void MappedFileCache::Insert(const std::string& path, const ContentPtr& content, DirectoryWatcher* watcher)
+{
+    assert(watcher);
+
+    auto it = m_stEntries.find(path);
+    if (it != m_stEntries.end())
+        Erase(it);
+
+    auto size = content->GetSize();
+    if (size > m_uMaxBytes)
+        return;
+
+    while (m_uTotalBytes + size > m_uMaxBytes && !m_stLru.empty())
+    {
+        auto victim = m_stEntries.find(m_stLru.back());
+        assert(victim != m_stEntries.end());
+        Erase(victim);
+    }
+
+    m_stLru.push_front(path);
+    try
+    {
+        Entry entry;
+        entry.Content = content;
+        entry.LruIterator = m_stLru.begin();
+        entry.Watcher = watcher;
+        m_stEntries.emplace(path, std::move(entry));
+    }
+    catch (...)
+    {
+        m_stLru.pop_front();
+        throw;
+    }
+    m_uTotalBytes += size;
+    ++watcher->Refs;
+}
+
+void MappedFileCache::Erase(std::unordered_map<std::string, Entry>::iterator it)noexcept
+{
+    assert(m_uTotalBytes >= it->second.Content->GetSize());
+    m_uTotalBytes -= it->second.Content->GetSize();
+    m_stLru.erase(it->second.LruIterator);
+    auto watcher = it->second.Watcher;
+    m_stEntries.erase(it);
+    Unwatch(watcher);
+}
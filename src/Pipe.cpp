@@ -21,8 +21,37 @@ Pipe Pipe::Create(bool ipc)
 struct UVConnectRequest
 {
     ::uv_connect_t Request;
+    AllocAccount Account { AllocCategory::Request, sizeof(UVConnectRequest) };
 };
 
+struct UVWriteHandleRequest
+{
+    ::uv_write_t Request;
+    ::uv_buf_t BufferDesc;
+    AllocAccount Account { AllocCategory::Request, sizeof(UVWriteHandleRequest) };
+
+    Stream::OnWriteCallbackType OnWrite;
+};
+
+namespace
+{
+    // 发送句柄时附带的数据，libuv不会修改其内容
+    char kHandlePayload[1] = { 0 };
+
+    Pipe::PendingHandleType ToPendingHandleType(::uv_handle_type type)noexcept
+    {
+        switch (type)
+        {
+            case UV_TCP:
+                return Pipe::PendingHandleType::Tcp;
+            case UV_NAMED_PIPE:
+                return Pipe::PendingHandleType::Pipe;
+            default:
+                return Pipe::PendingHandleType::Unknown;
+        }
+    }
+}
+
 void Pipe::OnUVConnect(::uv_connect_t* request, int status)noexcept
 {
     UniquePooledObject<UVConnectRequest> owner;
@@ -48,8 +77,34 @@ void Pipe::OnUVConnect(::uv_connect_t* request, int status)noexcept
     }
 }
 
+void Pipe::OnUVWriteHandle(::uv_write_t* request, int status)noexcept
+{
+    UniquePooledObject<UVWriteHandleRequest> owner;
+    owner.reset(static_cast<UVWriteHandleRequest*>(request->data));
+
+    auto handle = request->handle;
+    MOE_UV_GET_SELF(Pipe);
+
+    if (owner->OnWrite)
+    {
+        MOE_UV_CATCH_ALL_BEGIN
+            owner->OnWrite(static_cast<uv_errno_t>(status));
+        MOE_UV_CATCH_ALL_END
+    }
+
+    if (status != 0 && GetSelf<Pipe>(handle) == self)  // 由于穿越回调函数，需要检查所有权
+    {
+        MOE_UV_CATCH_ALL_BEGIN
+            self->OnError(static_cast<uv_errno_t>(status));
+        MOE_UV_CATCH_ALL_END
+
+        if (GetSelf<Pipe>(handle) == self)
+            self->Close();  // 发生错误时直接关闭管道
+    }
+}
+
 Pipe::Pipe(Pipe&& org)noexcept
-    : Stream(std::move(org)), m_pOnConnect(std::move(org.m_pOnConnect))
+    : Stream(std::move(org)), m_pOnConnect(std::move(org.m_pOnConnect)), m_pOnHandle(std::move(org.m_pOnHandle))
 {
 }
 
@@ -57,6 +112,7 @@ Pipe& Pipe::operator=(Pipe&& rhs)noexcept
 {
     Stream::operator=(std::move(rhs));
     m_pOnConnect = std::move(rhs.m_pOnConnect);
+    m_pOnHandle = std::move(rhs.m_pOnHandle);
     return *this;
 }
 
@@ -86,6 +142,72 @@ void Pipe::Connect(const char* name)
     req.data = object.release();
 }
 
+void Pipe::WriteHandle(Stream& target, const OnWriteCallbackType& cb)
+{
+    OnWriteCallbackType tmp(cb);
+    WriteHandle(target, std::move(tmp));
+}
+
+void Pipe::WriteHandle(Stream& target, OnWriteCallbackType&& cb)
+{
+    MOE_UV_GET_HANDLE(::uv_stream_t);
+    if (target.IsClosing())
+        MOE_THROW(BadArgumentException, "Target handle is already disposed");
+
+    MOE_UV_NEW(UVWriteHandleRequest);
+    object->OnWrite = std::move(cb);
+    object->BufferDesc = ::uv_buf_init(kHandlePayload, sizeof(kHandlePayload));
+
+    // 发起写操作
+    MOE_UV_CHECK(::uv_write2(&object->Request, handle, &(object->BufferDesc), 1,
+        reinterpret_cast<::uv_stream_t*>(target.GetHandle()), OnUVWriteHandle));
+
+    // 释放所有权，交由UV管理
+    auto& req = object->Request;
+    req.data = object.release();
+}
+
+size_t Pipe::GetPendingHandleCount()const noexcept
+{
+    if (IsClosing())
+        return 0;
+    MOE_UV_GET_HANDLE_NOTHROW(::uv_pipe_t);
+    auto ret = ::uv_pipe_pending_count(handle);
+    return ret > 0 ? static_cast<size_t>(ret) : 0;
+}
+
+Pipe::PendingHandleType Pipe::GetPendingHandleType()const noexcept
+{
+    if (IsClosing())
+        return PendingHandleType::Unknown;
+    MOE_UV_GET_HANDLE_NOTHROW(::uv_pipe_t);
+    return ToPendingHandleType(::uv_pipe_pending_type(handle));
+}
+
+TcpSocket Pipe::AcceptTcpSocket()
+{
+    MOE_UV_GET_HANDLE(::uv_pipe_t);
+    if (::uv_pipe_pending_count(handle) <= 0 || ::uv_pipe_pending_type(handle) != UV_TCP)
+        MOE_THROW(InvalidCallException, "No pending tcp handle");
+
+    auto socket = TcpSocket::Create();
+    MOE_UV_CHECK(::uv_accept(reinterpret_cast<::uv_stream_t*>(handle),
+        reinterpret_cast<::uv_stream_t*>(socket.GetHandle())));
+    return socket;
+}
+
+Pipe Pipe::AcceptPipe()
+{
+    MOE_UV_GET_HANDLE(::uv_pipe_t);
+    if (::uv_pipe_pending_count(handle) <= 0 || ::uv_pipe_pending_type(handle) != UV_NAMED_PIPE)
+        MOE_THROW(InvalidCallException, "No pending pipe handle");
+
+    auto pipe = Pipe::Create(false);
+    MOE_UV_CHECK(::uv_accept(reinterpret_cast<::uv_stream_t*>(handle),
+        reinterpret_cast<::uv_stream_t*>(pipe.GetHandle())));
+    return pipe;
+}
+
 std::string Pipe::GetSockName()
 {
     MOE_UV_GET_HANDLE(::uv_pipe_t);
@@ -129,3 +251,34 @@ void Pipe::OnConnect()
     if (m_pOnConnect)
         m_pOnConnect();
 }
+
+void Pipe::OnHandle(PendingHandleType type)
+{
+    if (m_pOnHandle)
+        m_pOnHandle(type);
+}
+
+void Pipe::OnData(BytesView data)
+{
+    // 句柄总是与数据一同到达，需要先于数据派发
+    size_t count = 0;
+    while ((count = GetPendingHandleCount()) > 0)
+    {
+        auto type = GetPendingHandleType();
+        if (type == PendingHandleType::Unknown)
+            break;
+
+        OnHandle(type);
+
+        // 没有被接收的句柄直接关闭，防止泄露
+        if (GetPendingHandleCount() == count)
+        {
+            if (type == PendingHandleType::Tcp)
+                AcceptTcpSocket();
+            else
+                AcceptPipe();
+        }
+    }
+
+    Stream::OnData(data);
+}
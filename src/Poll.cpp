@@ -31,27 +31,49 @@ void Poll::OnUVEvent(::uv_poll_s* handle, int status, int events)noexcept
 {
     MOE_UV_GET_SELF(Poll);
 
+    // 通过暂停已触发的事件模拟边沿触发，回调中可以直接Rearm
+    if (status == 0 && self->m_bEdgeTriggered)
+        self->Disarm(events);
+
     MOE_UV_CATCH_ALL_BEGIN
         self->OnEvent(status, events);
     MOE_UV_CATCH_ALL_END
 }
 
 Poll::Poll(Poll&& org)noexcept
-    : AsyncHandle(std::move(org)), m_pOnEvent(std::move(org.m_pOnEvent))
+    : AsyncHandle(std::move(org)), m_iEvents(org.m_iEvents), m_iArmedEvents(org.m_iArmedEvents),
+    m_bEdgeTriggered(org.m_bEdgeTriggered), m_pOnEvent(std::move(org.m_pOnEvent))
 {
 }
 
 Poll& Poll::operator=(Poll&& rhs)noexcept
 {
     AsyncHandle::operator=(std::move(rhs));
+    m_iEvents = rhs.m_iEvents;
+    m_iArmedEvents = rhs.m_iArmedEvents;
+    m_bEdgeTriggered = rhs.m_bEdgeTriggered;
     m_pOnEvent = std::move(rhs.m_pOnEvent);
     return *this;
 }
 
-void Poll::Start(int events)
+void Poll::Start(int events, bool edgeTriggered)
 {
     MOE_UV_GET_HANDLE(::uv_poll_t);
     MOE_UV_CHECK(::uv_poll_start(handle, events, OnUVEvent));
+
+    m_iEvents = events;
+    m_iArmedEvents = events;
+    m_bEdgeTriggered = edgeTriggered;
+}
+
+void Poll::Rearm()
+{
+    if (!m_bEdgeTriggered || m_iArmedEvents == m_iEvents)
+        return;
+
+    MOE_UV_GET_HANDLE(::uv_poll_t);
+    MOE_UV_CHECK(::uv_poll_start(handle, m_iEvents, OnUVEvent));
+    m_iArmedEvents = m_iEvents;
 }
 
 bool Poll::Stop()noexcept
@@ -60,6 +82,8 @@ bool Poll::Stop()noexcept
         return false;
     MOE_UV_GET_HANDLE_NOTHROW(::uv_poll_t);
     assert(handle);
+    m_iArmedEvents = 0;
+    m_iEvents = 0;
     return ::uv_poll_stop(handle) == 0;
 }
 
@@ -68,3 +92,20 @@ void Poll::OnEvent(int status, int events)
     if (m_pOnEvent)
         m_pOnEvent(status, events);
 }
+
+void Poll::Disarm(int events)noexcept
+{
+    MOE_UV_GET_HANDLE_NOTHROW(::uv_poll_t);
+    assert(handle);
+
+    auto armed = m_iArmedEvents & ~events;
+    if (armed == m_iArmedEvents)
+        return;
+
+    // 仅修改epoll的监听集合，理论上总是成功的
+    // 全部暂停时libuv不允许保留空的监听集合，只能停止句柄，其不再使RunLoop保持运行（见类注释）
+    m_iArmedEvents = armed;
+    auto ret = armed == 0 ? ::uv_poll_stop(handle) : ::uv_poll_start(handle, armed, OnUVEvent);
+    MOE_UNUSED(ret);
+    assert(ret == 0);
+}
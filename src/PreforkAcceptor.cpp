@@ -0,0 +1,292 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include <Moe.UV/PreforkAcceptor.hpp>
+
+#include <csignal>
+
+#include "UV.inl"
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+
+//////////////////////////////////////////////////////////////////////////////// PreforkMaster
+
+const int PreforkMaster::kChannelFd;
+const Time::Tick PreforkMaster::kRespawnDelay;
+
+PreforkMaster::PreforkMaster(const std::string& path, const std::vector<std::string>& args, size_t workerCount)
+    : m_stPath(path), m_stArgs(args), m_stListener(TcpSocket::Create()), m_stRespawnTimer(Timer::Create())
+{
+    if (workerCount == 0)
+        MOE_THROW(BadArgumentException, "Worker count must be positive");
+
+    m_stListener.SetOnConnectionCallback([this]() { OnConnection(); });
+
+    m_stRespawnTimer.SetFirstTime(kRespawnDelay);
+    m_stRespawnTimer.SetInterval(0);
+    m_stRespawnTimer.SetOnTimeCallback([this]() { RespawnDeadWorkers(); });
+
+    m_stWorkers.resize(workerCount);
+    try
+    {
+        for (size_t i = 0; i < workerCount; ++i)
+            SpawnWorker(i);
+    }
+    catch (...)
+    {
+        Close();
+        throw;
+    }
+}
+
+PreforkMaster::~PreforkMaster()
+{
+    Close();
+}
+
+size_t PreforkMaster::GetAliveWorkerCount()const noexcept
+{
+    size_t ret = 0;
+    for (const auto& worker : m_stWorkers)
+    {
+        if (worker && worker->Alive)
+            ++ret;
+    }
+    return ret;
+}
+
+void PreforkMaster::Listen(const EndPoint& address, unsigned backlog, bool ipv6Only)
+{
+    if (m_bClosed)
+        MOE_THROW(InvalidCallException, "Acceptor is closed");
+
+    m_stListener.Bind(address, ipv6Only);
+    m_stListener.Listen(backlog);
+}
+
+void PreforkMaster::Close()noexcept
+{
+    if (m_bClosed)
+        return;
+    m_bClosed = true;
+
+    m_stListener.Close();
+    m_stRespawnTimer.Close();
+
+    // 进程句柄也需要关闭，否则退出回调会访问到已经销毁的对象
+    for (auto& worker : m_stWorkers)
+    {
+        if (!worker)
+            continue;
+
+        worker->Channel.Close();
+        if (worker->Alive)
+        {
+            try
+            {
+                worker->Process.Kill(SIGTERM);
+            }
+            catch (const std::exception& ex)
+            {
+                MOE_LOG_ERROR("Kill worker error: {0}", ex.what());
+            }
+        }
+        worker->Process.Close();
+        worker->Alive = false;
+    }
+
+    for (auto& socket : m_stHandOff)
+        socket.Close();
+}
+
+void PreforkMaster::OnWorkerExit(size_t index, int64_t exitStatus, int termSignal)
+{
+    if (m_pOnWorkerExit)
+        m_pOnWorkerExit(index, exitStatus, termSignal);
+}
+
+void PreforkMaster::SpawnWorker(size_t index)
+{
+    assert(index < m_stWorkers.size());
+    static_assert(kChannelFd == 3, "Channel must follow stdin, stdout and stderr");
+
+    auto channel = Pipe::Create(true);
+
+    vector<const char*> argv;
+    argv.reserve(m_stArgs.size() + 2);
+    argv.push_back(m_stPath.c_str());
+    for (const auto& arg : m_stArgs)
+        argv.push_back(arg.c_str());
+    argv.push_back(nullptr);
+
+    vector<SubProcess::StdioContainer> stdio {
+        SubProcess::StdioContainer::InheritFd(0),
+        SubProcess::StdioContainer::InheritFd(1),
+        SubProcess::StdioContainer::InheritFd(2),
+        SubProcess::StdioContainer::CreatePipe(channel, true, true),
+    };
+
+    auto process = SubProcess::Spawn(m_stPath.c_str(), argv.data(), stdio);
+    unique_ptr<Worker> worker(new Worker(std::move(channel), std::move(process)));
+
+    // 只标记失效，对象的销毁推迟到重启时进行，避免在回调中析构回调本身
+    worker->Process.SetOnExitCallback([this, index](int64_t exitStatus, int termSignal) {
+        auto& w = m_stWorkers[index];
+        assert(w);
+        w->Alive = false;
+        w->Channel.Close();
+
+        OnWorkerExit(index, exitStatus, termSignal);
+
+        if (!m_bClosed)
+            m_stRespawnTimer.Start();
+    });
+
+    m_stWorkers[index] = std::move(worker);
+}
+
+void PreforkMaster::RespawnDeadWorkers()
+{
+    if (m_bClosed)
+        return;
+
+    bool failed = false;
+    for (size_t i = 0; i < m_stWorkers.size(); ++i)
+    {
+        auto& worker = m_stWorkers[i];
+        if (worker && worker->Alive)
+            continue;
+
+        try
+        {
+            SpawnWorker(i);
+        }
+        catch (const std::exception& ex)
+        {
+            MOE_LOG_ERROR("Respawn worker {0} error: {1}", i, ex.what());
+            failed = true;
+        }
+    }
+
+    if (failed)
+        m_stRespawnTimer.Start();
+}
+
+PreforkMaster::Worker* PreforkMaster::SelectWorker()noexcept
+{
+    Worker* ret = nullptr;
+    size_t selected = 0;
+
+    // 从上次选中的下一个开始查找在途连接最少的子进程，在途数相同时即为轮询
+    auto count = m_stWorkers.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto index = (m_uNextWorker + i) % count;
+        auto worker = m_stWorkers[index].get();
+        if (!worker || !worker->Alive || worker->Channel.IsClosing())
+            continue;
+
+        if (!ret || worker->InFlight < ret->InFlight)
+        {
+            ret = worker;
+            selected = index;
+        }
+    }
+
+    if (ret)
+        m_uNextWorker = (selected + 1) % count;
+    return ret;
+}
+
+void PreforkMaster::OnConnection()
+{
+    auto socket = m_stListener.Accept();
+
+    auto worker = SelectWorker();
+    if (!worker)
+    {
+        MOE_LOG_ERROR("No worker available, connection dropped");
+        return;
+    }
+
+    // 连接需要保持打开直到发送完成
+    m_stHandOff.push_back(std::move(socket));
+    auto it = std::prev(m_stHandOff.end());
+    ++worker->InFlight;
+
+    try
+    {
+        worker->Channel.WriteHandle(*it, [this, it, worker](int status) {
+            // 子进程重启后worker可能已经被替换
+            for (auto& w : m_stWorkers)
+            {
+                if (w.get() == worker)
+                {
+                    assert(worker->InFlight > 0);
+                    --worker->InFlight;
+                    break;
+                }
+            }
+
+            if (status != 0)
+                MOE_LOG_ERROR("Hand off connection error: {0}", ::uv_strerror(status));
+
+            it->Close();
+            m_stHandOff.erase(it);
+        });
+    }
+    catch (...)
+    {
+        --worker->InFlight;
+        m_stHandOff.erase(it);
+        throw;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////// PreforkWorker
+
+PreforkWorker::PreforkWorker()
+    : m_stChannel(Pipe::Create(true))
+{
+    m_stChannel.Open(PreforkMaster::kChannelFd);
+
+    m_stChannel.SetOnHandleCallback([this](Pipe::PendingHandleType type) {
+        if (type == Pipe::PendingHandleType::Tcp)
+            OnConnection(m_stChannel.AcceptTcpSocket());
+    });
+    m_stChannel.SetOnEofCallback([this]() {
+        Close();
+        OnMasterExit();
+    });
+    m_stChannel.SetOnErrorCallback([this](int status) {
+        MOE_LOG_ERROR("Prefork channel error: {0}", ::uv_strerror(status));
+        Close();
+        OnMasterExit();
+    });
+}
+
+void PreforkWorker::Start()
+{
+    m_stChannel.StartRead();
+}
+
+void PreforkWorker::Close()noexcept
+{
+    m_stChannel.Close();
+}
+
+void PreforkWorker::OnConnection(TcpSocket&& socket)
+{
+    if (m_pOnConnection)
+        m_pOnConnection(std::move(socket));
+}
+
+void PreforkWorker::OnMasterExit()
+{
+    if (m_pOnMasterExit)
+        m_pOnMasterExit();
+}
@@ -4,6 +4,7 @@
  * @date 2018/8/14
  */
 #include <Moe.UV/Process.hpp>
+#include <Moe.UV/Pipe.hpp>
 
 #include "UV.inl"
 
@@ -18,13 +19,89 @@ void Process::Kill(int pid, int signum)
     MOE_UV_CHECK(::uv_kill(pid, signum));
 }
 
+//////////////////////////////////////////////////////////////////////////////// SubProcess::StdioContainer
+
+SubProcess::StdioContainer SubProcess::StdioContainer::Ignore()noexcept
+{
+    return StdioContainer();
+}
+
+SubProcess::StdioContainer SubProcess::StdioContainer::CreatePipe(Pipe& pipe, bool readable, bool writable)noexcept
+{
+    StdioContainer ret;
+    ret.ContainerType = Type::CreatePipe;
+    ret.Target = &pipe;
+    ret.Readable = readable;
+    ret.Writable = writable;
+    return ret;
+}
+
+SubProcess::StdioContainer SubProcess::StdioContainer::InheritFd(int fd)noexcept
+{
+    StdioContainer ret;
+    ret.ContainerType = Type::InheritFd;
+    ret.Fd = fd;
+    return ret;
+}
+
+SubProcess::StdioContainer SubProcess::StdioContainer::InheritStream(Stream& stream)noexcept
+{
+    StdioContainer ret;
+    ret.ContainerType = Type::InheritStream;
+    ret.Target = &stream;
+    return ret;
+}
+
 //////////////////////////////////////////////////////////////////////////////// SubProcess
 
 SubProcess SubProcess::Spawn(const char* path, const char* args[], const char* env[], const char* cwd, unsigned flags,
     uint32_t uid, uint32_t gid)
 {
+    return Spawn(path, args, EmptyRefOf<vector<StdioContainer>>(), env, cwd, flags, uid, gid);
+}
+
+SubProcess SubProcess::Spawn(const char* path, const char* args[], const std::vector<StdioContainer>& stdio,
+    const char* env[], const char* cwd, unsigned flags, uint32_t uid, uint32_t gid)
+{
+    vector<::uv_stdio_container_t> containers;
+    containers.resize(stdio.size());
+    for (size_t i = 0; i < stdio.size(); ++i)
+    {
+        auto& src = stdio[i];
+        auto& dest = containers[i];
+        ::memset(&dest, 0, sizeof(dest));
+
+        switch (src.ContainerType)
+        {
+            case StdioContainer::Type::Ignore:
+                dest.flags = UV_IGNORE;
+                break;
+            case StdioContainer::Type::CreatePipe:
+                if (!src.Target || src.Target->IsClosing())
+                    MOE_THROW(BadArgumentException, "Invalid pipe at stdio {0}", i);
+                dest.flags = static_cast<::uv_stdio_flags>(UV_CREATE_PIPE | (src.Readable ? UV_READABLE_PIPE : 0) |
+                    (src.Writable ? UV_WRITABLE_PIPE : 0));
+                dest.data.stream = reinterpret_cast<::uv_stream_t*>(src.Target->GetHandle());
+                break;
+            case StdioContainer::Type::InheritFd:
+                dest.flags = UV_INHERIT_FD;
+                dest.data.fd = src.Fd;
+                break;
+            case StdioContainer::Type::InheritStream:
+                if (!src.Target || src.Target->IsClosing())
+                    MOE_THROW(BadArgumentException, "Invalid stream at stdio {0}", i);
+                dest.flags = UV_INHERIT_STREAM;
+                dest.data.stream = reinterpret_cast<::uv_stream_t*>(src.Target->GetHandle());
+                break;
+            default:
+                assert(false);
+                MOE_THROW(BadArgumentException, "Bad stdio type at {0}", i);
+        }
+    }
+
     ::uv_process_options_t options;
     ::memset(&options, 0, sizeof(options));
+    options.exit_cb = OnUVProcessExit;
     options.file = path;
     options.args = const_cast<char**>(args);
     options.env = const_cast<char**>(env);
@@ -32,6 +109,8 @@ SubProcess SubProcess::Spawn(const char* path, const char* args[], const char* e
     options.flags = flags;
     options.uid = uid;
     options.gid = gid;
+    options.stdio_count = static_cast<int>(containers.size());
+    options.stdio = containers.empty() ? nullptr : containers.data();
 
     MOE_UV_NEW(::uv_process_t);
     MOE_UV_CHECK(::uv_spawn(GetCurrentUVLoop(), object.get(), &options));
@@ -42,6 +121,10 @@ void SubProcess::OnUVProcessExit(::uv_process_t* handle, int64_t exitStatus, int
 {
     MOE_UV_GET_SELF(SubProcess);
 
+    self->m_bRunning = false;
+    self->m_llExitStatus = exitStatus;
+    self->m_iTermSignal = termSignal;
+
     MOE_UV_CATCH_ALL_BEGIN
         self->OnExit(exitStatus, termSignal);
     MOE_UV_CATCH_ALL_END
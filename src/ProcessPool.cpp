@@ -0,0 +1,434 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include <Moe.UV/ProcessPool.hpp>
+
+#include <csignal>
+
+#include "UV.inl"
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+
+namespace
+{
+    void WriteFrame(Stream& stream, BytesView data)
+    {
+        if (data.GetSize() > ProcessPool::kMaxFrameSize)
+            MOE_THROW(BadArgumentException, "Frame too large");
+
+        // 帧头和负载合并为一次写入，避免拆成两个写请求
+        auto length = static_cast<uint32_t>(data.GetSize());
+        std::vector<uint8_t> frame;
+        frame.reserve(4 + length);
+        frame.push_back(static_cast<uint8_t>(length >> 24));
+        frame.push_back(static_cast<uint8_t>(length >> 16));
+        frame.push_back(static_cast<uint8_t>(length >> 8));
+        frame.push_back(static_cast<uint8_t>(length));
+        frame.insert(frame.end(), data.GetBuffer(), data.GetBuffer() + length);
+
+        stream.Write(BytesView(frame.data(), frame.size()));
+    }
+
+    /**
+     * @brief 从流中切分出完整的帧
+     * @return 帧长度超过上限时返回UV_EMSGSIZE
+     *
+     * onFrame返回false时丢弃剩余数据，用于回调中关闭了管道的情况。
+     */
+    template <typename TCallback>
+    int ReadFrames(std::vector<uint8_t>& buffer, BytesView data, TCallback&& onFrame)
+    {
+        buffer.insert(buffer.end(), data.GetBuffer(), data.GetBuffer() + data.GetSize());
+
+        size_t offset = 0;
+        int ret = 0;
+        while (buffer.size() - offset >= 4)
+        {
+            auto p = buffer.data() + offset;
+            auto length = (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+                (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+            if (length > ProcessPool::kMaxFrameSize)
+            {
+                ret = UV_EMSGSIZE;
+                break;
+            }
+            if (buffer.size() - offset - 4 < length)
+                break;
+
+            if (!onFrame(BytesView(p + 4, length)))
+            {
+                buffer.clear();
+                return 0;
+            }
+            offset += 4 + length;
+        }
+
+        buffer.erase(buffer.begin(), buffer.begin() + offset);
+        return ret;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////// ProcessPool
+
+const int ProcessPool::kChannelFd;
+const Time::Tick ProcessPool::kRespawnDelay;
+const uint32_t ProcessPool::kMaxFrameSize;
+
+ProcessPool::ProcessPool(const std::string& path, const std::vector<std::string>& args, size_t workerCount)
+    : m_stPath(path), m_stArgs(args), m_stRespawnTimer(Timer::Create())
+{
+    if (workerCount == 0)
+        MOE_THROW(BadArgumentException, "Worker count must be positive");
+
+    m_stRespawnTimer.SetFirstTime(kRespawnDelay);
+    m_stRespawnTimer.SetInterval(0);
+    m_stRespawnTimer.SetOnTimeCallback([this]() { RespawnDeadWorkers(); });
+
+    m_stWorkers.resize(workerCount);
+    try
+    {
+        for (size_t i = 0; i < workerCount; ++i)
+            SpawnWorker(i);
+    }
+    catch (...)
+    {
+        Close();
+        throw;
+    }
+}
+
+ProcessPool::~ProcessPool()
+{
+    Close();
+}
+
+size_t ProcessPool::GetAliveWorkerCount()const noexcept
+{
+    size_t ret = 0;
+    for (const auto& worker : m_stWorkers)
+    {
+        if (worker && worker->Alive)
+            ++ret;
+    }
+    return ret;
+}
+
+void ProcessPool::Submit(BytesView job, const OnResponseCallbackType& cb)
+{
+    Submit(job, OnResponseCallbackType(cb));
+}
+
+void ProcessPool::Submit(BytesView job, OnResponseCallbackType&& cb)
+{
+    if (m_bClosed)
+        MOE_THROW(InvalidCallException, "Pool is closed");
+    if (job.GetSize() > kMaxFrameSize)
+        MOE_THROW(BadArgumentException, "Job too large");
+
+    // 队列非空时说明没有空闲的子进程，直接排队保证先后顺序
+    if (m_stQueue.empty())
+    {
+        auto count = m_stWorkers.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto index = (m_uNextWorker + i) % count;
+            auto worker = m_stWorkers[index].get();
+            if (!worker || !worker->Alive || worker->Busy || worker->Channel.IsClosing())
+                continue;
+
+            m_uNextWorker = (index + 1) % count;
+            Dispatch(*worker, job, std::move(cb));
+            return;
+        }
+    }
+
+    Job item;
+    item.Payload.assign(job.GetBuffer(), job.GetBuffer() + job.GetSize());
+    item.OnResponse = std::move(cb);
+    m_stQueue.emplace_back(std::move(item));
+}
+
+void ProcessPool::Close()noexcept
+{
+    if (m_bClosed)
+        return;
+    m_bClosed = true;
+
+    m_stRespawnTimer.Close();
+
+    // 进程句柄也需要关闭，否则退出回调会访问到已经销毁的对象
+    for (auto& worker : m_stWorkers)
+    {
+        if (!worker)
+            continue;
+
+        worker->Channel.Close();
+        if (worker->Alive)
+        {
+            try
+            {
+                worker->Process.Kill(SIGTERM);
+            }
+            catch (const std::exception& ex)
+            {
+                MOE_LOG_ERROR("Kill worker error: {0}", ex.what());
+            }
+        }
+        worker->Process.Close();
+        worker->Alive = false;
+        FailWorker(*worker, UV_ECANCELED);
+    }
+
+    auto queue = std::move(m_stQueue);
+    m_stQueue.clear();
+    for (auto& job : queue)
+    {
+        MOE_UV_CATCH_ALL_BEGIN
+            if (job.OnResponse)
+                job.OnResponse(UV_ECANCELED, BytesView());
+        MOE_UV_CATCH_ALL_END
+    }
+}
+
+void ProcessPool::OnWorkerExit(size_t index, int64_t exitStatus, int termSignal)
+{
+    if (m_pOnWorkerExit)
+        m_pOnWorkerExit(index, exitStatus, termSignal);
+}
+
+void ProcessPool::SpawnWorker(size_t index)
+{
+    assert(index < m_stWorkers.size());
+    static_assert(kChannelFd == 3, "Channel must follow stdin, stdout and stderr");
+
+    auto channel = Pipe::Create(false);
+
+    vector<const char*> argv;
+    argv.reserve(m_stArgs.size() + 2);
+    argv.push_back(m_stPath.c_str());
+    for (const auto& arg : m_stArgs)
+        argv.push_back(arg.c_str());
+    argv.push_back(nullptr);
+
+    vector<SubProcess::StdioContainer> stdio {
+        SubProcess::StdioContainer::InheritFd(0),
+        SubProcess::StdioContainer::InheritFd(1),
+        SubProcess::StdioContainer::InheritFd(2),
+        SubProcess::StdioContainer::CreatePipe(channel, true, true),
+    };
+
+    auto process = SubProcess::Spawn(m_stPath.c_str(), argv.data(), stdio);
+    unique_ptr<Worker> worker(new Worker(std::move(channel), std::move(process)));
+    auto w = worker.get();
+
+    // 回调保存在Worker自身的句柄上，因此直接持有其指针是安全的
+    worker->Channel.SetOnDataCallback([this, w](BytesView data) {
+        auto ret = ReadFrames(w->ReadBuffer, data, [this, w](BytesView frame) {
+            if (!w->Busy)
+            {
+                MOE_UV_ASYNC_LOG_ERROR("Unexpected response from worker {0}", w->Process.GetPid());
+                return true;
+            }
+
+            w->Busy = false;
+            auto cb = std::move(w->OnResponse);
+            w->OnResponse = nullptr;
+
+            MOE_UV_CATCH_ALL_BEGIN
+                if (cb)
+                    cb(0, frame);
+            MOE_UV_CATCH_ALL_END
+            return !w->Channel.IsClosing();
+        });
+
+        // 协议错误时无法再恢复同步，直接结束子进程
+        if (ret < 0)
+        {
+            MOE_UV_ASYNC_LOG_ERROR("Worker protocol error: {0}", ::uv_strerror(ret));
+            w->Channel.Close();
+            FailWorker(*w, ret);
+            if (w->Alive)
+                w->Process.Kill(SIGKILL);
+        }
+
+        if (!m_bClosed)
+            DispatchQueued();
+    });
+    worker->Channel.SetOnEofCallback([this, w]() {
+        w->Channel.Close();
+        FailWorker(*w, UV_ECONNRESET);
+        if (w->Alive)
+            w->Process.Kill(SIGTERM);
+    });
+    worker->Channel.SetOnErrorCallback([this, w](int status) {
+        w->Channel.Close();
+        FailWorker(*w, status);
+        if (w->Alive)
+            w->Process.Kill(SIGTERM);
+    });
+
+    // 只标记失效，对象的销毁推迟到重启时进行，避免在回调中析构回调本身
+    worker->Process.SetOnExitCallback([this, index](int64_t exitStatus, int termSignal) {
+        auto& w = m_stWorkers[index];
+        assert(w);
+        w->Alive = false;
+        w->Channel.Close();
+        FailWorker(*w, UV_ECONNRESET);
+
+        OnWorkerExit(index, exitStatus, termSignal);
+
+        if (!m_bClosed)
+            m_stRespawnTimer.Start();
+    });
+
+    worker->Channel.StartRead();
+    m_stWorkers[index] = std::move(worker);
+}
+
+void ProcessPool::RespawnDeadWorkers()
+{
+    if (m_bClosed)
+        return;
+
+    bool failed = false;
+    for (size_t i = 0; i < m_stWorkers.size(); ++i)
+    {
+        auto& worker = m_stWorkers[i];
+        if (worker && worker->Alive)
+            continue;
+
+        try
+        {
+            SpawnWorker(i);
+        }
+        catch (const std::exception& ex)
+        {
+            MOE_LOG_ERROR("Respawn worker {0} error: {1}", i, ex.what());
+            failed = true;
+        }
+    }
+
+    if (failed)
+        m_stRespawnTimer.Start();
+
+    DispatchQueued();
+}
+
+void ProcessPool::Dispatch(Worker& worker, BytesView job, OnResponseCallbackType&& cb)
+{
+    assert(worker.Alive && !worker.Busy);
+
+    WriteFrame(worker.Channel, job);
+    worker.Busy = true;
+    worker.OnResponse = std::move(cb);
+}
+
+void ProcessPool::DispatchQueued()
+{
+    auto count = m_stWorkers.size();
+    for (size_t i = 0; i < count && !m_stQueue.empty(); ++i)
+    {
+        auto index = (m_uNextWorker + i) % count;
+        auto worker = m_stWorkers[index].get();
+        if (!worker || !worker->Alive || worker->Busy || worker->Channel.IsClosing())
+            continue;
+
+        auto job = std::move(m_stQueue.front());
+        m_stQueue.pop_front();
+        m_uNextWorker = (index + 1) % count;
+
+        try
+        {
+            Dispatch(*worker, BytesView(job.Payload.data(), job.Payload.size()), std::move(job.OnResponse));
+        }
+        catch (const std::exception& ex)
+        {
+            MOE_UV_ASYNC_LOG_ERROR("Dispatch job error: {0}", ex.what());
+
+            MOE_UV_CATCH_ALL_BEGIN
+                if (job.OnResponse)
+                    job.OnResponse(UV_EPIPE, BytesView());
+            MOE_UV_CATCH_ALL_END
+        }
+    }
+}
+
+void ProcessPool::FailWorker(Worker& worker, int status)noexcept
+{
+    worker.ReadBuffer.clear();
+    if (!worker.Busy)
+        return;
+
+    worker.Busy = false;
+    auto cb = std::move(worker.OnResponse);
+    worker.OnResponse = nullptr;
+
+    MOE_UV_CATCH_ALL_BEGIN
+        if (cb)
+            cb(status, BytesView());
+    MOE_UV_CATCH_ALL_END
+}
+
+//////////////////////////////////////////////////////////////////////////////// ProcessPoolWorker
+
+ProcessPoolWorker::ProcessPoolWorker()
+    : m_stChannel(Pipe::Create(false))
+{
+    m_stChannel.Open(ProcessPool::kChannelFd);
+
+    m_stChannel.SetOnDataCallback([this](BytesView data) { OnData(data); });
+    m_stChannel.SetOnEofCallback([this]() {
+        Close();
+        OnMasterExit();
+    });
+    m_stChannel.SetOnErrorCallback([this](int status) {
+        MOE_LOG_ERROR("Process pool channel error: {0}", ::uv_strerror(status));
+        Close();
+        OnMasterExit();
+    });
+}
+
+void ProcessPoolWorker::Start()
+{
+    m_stChannel.StartRead();
+}
+
+void ProcessPoolWorker::Reply(BytesView response)
+{
+    WriteFrame(m_stChannel, response);
+}
+
+void ProcessPoolWorker::Close()noexcept
+{
+    m_stChannel.Close();
+}
+
+void ProcessPoolWorker::OnJob(BytesView job)
+{
+    if (m_pOnJob)
+        m_pOnJob(job);
+}
+
+void ProcessPoolWorker::OnMasterExit()
+{
+    if (m_pOnMasterExit)
+        m_pOnMasterExit();
+}
+
+void ProcessPoolWorker::OnData(BytesView data)
+{
+    auto ret = ReadFrames(m_stReadBuffer, data, [this](BytesView job) {
+        OnJob(job);
+        return !m_stChannel.IsClosing();
+    });
+    if (ret < 0)
+    {
+        MOE_LOG_ERROR("Process pool protocol error: {0}", ::uv_strerror(ret));
+        Close();
+        OnMasterExit();
+    }
+}
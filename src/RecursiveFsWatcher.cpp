@@ -0,0 +1,404 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include <Moe.UV/RecursiveFsWatcher.hpp>
+
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <unordered_set>
+#include <sys/stat.h>
+
+#include "UV.inl"
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+
+namespace
+{
+    string JoinPath(const string& directory, const char* name)
+    {
+        if (directory.empty())
+            return name;
+
+        string ret;
+        ret.reserve(directory.size() + 1 + ::strlen(name));
+        ret.append(directory);
+        ret.push_back('/');
+        ret.append(name);
+        return ret;
+    }
+
+    bool IsDirectory(const string& path, int& status)noexcept
+    {
+        ::uv_fs_t req;
+        status = ::uv_fs_lstat(nullptr, &req, path.c_str(), nullptr);
+        auto ret = status == 0 && (req.statbuf.st_mode & S_IFMT) == S_IFDIR;
+        ::uv_fs_req_cleanup(&req);
+        return ret;
+    }
+}
+
+const Time::Tick RecursiveFsWatcher::kDefaultCoalesceWindow;
+const size_t RecursiveFsWatcher::kMaxScanPerFlush;
+
+RecursiveFsWatcher::RecursiveFsWatcher(Time::Tick window)
+    : m_ullWindow(window), m_stFlushTimer(Timer::Create())
+{
+    m_stFlushTimer.SetFirstTime(window);
+    m_stFlushTimer.SetInterval(0);
+    m_stFlushTimer.SetOnTimeCallback([this]() { Flush(); });
+}
+
+RecursiveFsWatcher::~RecursiveFsWatcher()
+{
+    Stop();
+}
+
+void RecursiveFsWatcher::Start(const std::string& root)
+{
+    if (m_bWatching)
+        MOE_THROW(InvalidCallException, "Watcher is already started");
+    if (root.empty())
+        MOE_THROW(BadArgumentException, "Root required");
+
+    m_stRoot = root;
+    while (m_stRoot.size() > 1 && (m_stRoot.back() == '/' || m_stRoot.back() == '\\'))
+        m_stRoot.pop_back();
+
+#if defined(MOE_WINDOWS) || defined(__APPLE__)
+    m_bRecursiveNative = true;
+    MOE_UV_CHECK(AddWatch(string(), UV_FS_EVENT_RECURSIVE));
+#else
+    // inotify不支持递归，需要逐个目录建立监控
+    m_bRecursiveNative = false;
+    MOE_UV_CHECK(AddWatch(string(), 0));
+    try
+    {
+        m_stScanQueue.emplace_back();  // 根目录，其中已有的条目不作为新建通知
+
+        vector<Change> created;
+        Walk(numeric_limits<size_t>::max(), created);
+        assert(created.empty());
+    }
+    catch (...)
+    {
+        Stop();
+        throw;
+    }
+#endif
+
+    m_bWatching = true;
+}
+
+void RecursiveFsWatcher::Stop()noexcept
+{
+    m_bWatching = false;
+    m_stFlushTimer.Stop();
+    m_stWatchers.clear();
+    m_stScanQueue.clear();
+    m_stPending.clear();
+    m_stPendingIndex.clear();
+    m_stPendingErrors.clear();
+}
+
+void RecursiveFsWatcher::OnChanges(const std::vector<Change>& changes)
+{
+    if (m_pOnChanges)
+        m_pOnChanges(changes);
+}
+
+void RecursiveFsWatcher::OnError(const std::string& path, int status)
+{
+    if (m_pOnError)
+        m_pOnError(path, status);
+}
+
+std::string RecursiveFsWatcher::ToAbsolute(const std::string& relative)const
+{
+    if (relative.empty())
+        return m_stRoot;
+    if (m_stRoot == "/")
+        return m_stRoot + relative;
+    return m_stRoot + "/" + relative;
+}
+
+int RecursiveFsWatcher::AddWatch(const std::string& relative, unsigned flags)
+{
+    assert(m_stWatchers.find(relative) == m_stWatchers.end());
+
+    auto watcher = FsEvent::Create([this, relative](const char* filename, int events, int status) {
+        OnFsEvent(relative, filename, events, status);
+    });
+
+    auto ret = watcher.TryStart(ToAbsolute(relative).c_str(), flags);
+    if (ret < 0)
+        return ret;
+
+    m_stWatchers.emplace(relative, std::move(watcher));
+    return 0;
+}
+
+void RecursiveFsWatcher::ScanDirectory(const ScanTask& task, std::vector<Change>& created)
+{
+    const auto& relative = task.Path;
+
+    // 先建立监控再遍历，遍历期间新建的条目不会被遗漏
+    if (m_stWatchers.find(relative) == m_stWatchers.end())
+    {
+        auto ret = AddWatch(relative, 0);
+        if (ret < 0)
+        {
+            RecordError(relative, ret);
+            return;
+        }
+    }
+
+    // 同步遍历单个目录，子目录放入队列
+    ::uv_fs_t req;
+    auto ret = ::uv_fs_scandir(nullptr, &req, ToAbsolute(relative).c_str(), 0, nullptr);
+    if (ret < 0)
+    {
+        ::uv_fs_req_cleanup(&req);
+        RecordError(relative, ret);
+        return;
+    }
+
+    try
+    {
+        ::uv_dirent_t ent;
+        while (::uv_fs_scandir_next(&req, &ent) != UV_EOF)
+        {
+            auto child = JoinPath(relative, ent.name);
+
+            auto type = ent.type;
+            if (type == UV_DIRENT_UNKNOWN)
+            {
+                auto status = 0;
+                type = IsDirectory(ToAbsolute(child), status) ? UV_DIRENT_DIR : UV_DIRENT_FILE;
+            }
+
+            if (task.ReportCreated)
+            {
+                Change change;
+                change.Path = child;
+                change.Events = UV_RENAME;
+                created.emplace_back(std::move(change));
+            }
+
+            // 不跟随符号链接，避免循环
+            if (type == UV_DIRENT_DIR)
+            {
+                ScanTask subtask;
+                subtask.Path = std::move(child);
+                subtask.ReportCreated = task.ReportCreated;
+                m_stScanQueue.emplace_back(std::move(subtask));
+            }
+        }
+    }
+    catch (...)
+    {
+        ::uv_fs_req_cleanup(&req);
+        throw;
+    }
+    ::uv_fs_req_cleanup(&req);
+}
+
+void RecursiveFsWatcher::Walk(size_t budget, std::vector<Change>& created)
+{
+    while (budget > 0 && !m_stScanQueue.empty())
+    {
+        auto task = std::move(m_stScanQueue.front());
+        m_stScanQueue.pop_front();
+        ScanDirectory(task, created);
+        --budget;
+    }
+}
+
+void RecursiveFsWatcher::RemoveTree(const std::string& relative)noexcept
+{
+    if (relative.empty())
+        return;
+
+    auto isInTree = [&](const string& path) {
+        return path.compare(0, relative.size(), relative) == 0 &&
+            (path.size() == relative.size() || path[relative.size()] == '/');
+    };
+
+    // 有序容器中同级的"a-b"会排在子目录"a/x"之前，因此需要逐个判断前缀
+    auto it = m_stWatchers.lower_bound(relative);
+    while (it != m_stWatchers.end() && it->first.compare(0, relative.size(), relative) == 0)
+    {
+        if (isInTree(it->first))
+            it = m_stWatchers.erase(it);
+        else
+            ++it;
+    }
+
+    m_stScanQueue.erase(std::remove_if(m_stScanQueue.begin(), m_stScanQueue.end(),
+        [&](const ScanTask& task) { return isInTree(task.Path); }), m_stScanQueue.end());
+}
+
+bool RecursiveFsWatcher::IsSelfEvent(const std::string& relative)const
+{
+    auto pos = relative.rfind('/');
+    if (pos == string::npos)
+        return false;
+
+    auto parent = relative.substr(0, pos);
+    auto parentPos = parent.rfind('/');
+    auto parentName = parentPos == string::npos ? parent : parent.substr(parentPos + 1);
+    if (relative.compare(pos + 1, string::npos, parentName) != 0)
+        return false;
+
+    auto status = 0;
+    IsDirectory(ToAbsolute(parent), status);
+    return status < 0;
+}
+
+void RecursiveFsWatcher::Record(const std::string& relative, int events)
+{
+    auto it = m_stPendingIndex.find(relative);
+    if (it != m_stPendingIndex.end())
+    {
+        m_stPending[it->second].Events |= events;
+        return;
+    }
+
+    if (m_stPending.empty() && m_stPendingErrors.empty())
+        m_stFlushTimer.Start();
+
+    Change change;
+    change.Path = relative;
+    change.Events = events;
+    m_stPending.emplace_back(std::move(change));
+    m_stPendingIndex.emplace(relative, m_stPending.size() - 1);
+}
+
+void RecursiveFsWatcher::RecordError(const std::string& relative, int status)
+{
+    if (m_stPending.empty() && m_stPendingErrors.empty())
+        m_stFlushTimer.Start();
+
+    m_stPendingErrors.emplace_back(relative, status);
+}
+
+void RecursiveFsWatcher::OnFsEvent(const std::string& directory, const char* filename, int events,
+    int status)noexcept
+{
+    // 此处在FsEvent回调中，不能增删监控对象，统一推迟到合并窗口结束时处理
+    try
+    {
+        if (status < 0)
+        {
+            RecordError(directory, status);
+            return;
+        }
+
+        if (!filename)
+        {
+            Record(directory, events);
+            return;
+        }
+
+        auto path = JoinPath(directory, filename);
+#ifdef MOE_WINDOWS
+        for (auto& ch : path)
+        {
+            if (ch == '\\')
+                ch = '/';
+        }
+#endif
+        Record(path, events);
+    }
+    catch (const std::bad_alloc&)
+    {
+        MOE_UV_ASYNC_LOG_ERROR("Out of memory when recording file system event");
+    }
+}
+
+void RecursiveFsWatcher::Flush()
+{
+    auto changes = std::move(m_stPending);
+    auto errors = std::move(m_stPendingErrors);
+    m_stPending.clear();
+    m_stPendingIndex.clear();
+    m_stPendingErrors.clear();
+
+    // 根据重命名事件增减子目录监控
+    if (m_bWatching && !m_bRecursiveNative)
+    {
+        vector<Change> created;
+        vector<Change> kept;
+        kept.reserve(changes.size());
+        for (auto& change : changes)
+        {
+            if (!(change.Events & UV_RENAME))
+            {
+                kept.emplace_back(std::move(change));
+                continue;
+            }
+
+            auto ret = 0;
+            auto isDirectory = IsDirectory(ToAbsolute(change.Path), ret);
+            if (isDirectory)
+            {
+                // 同一目录可能已在队列中尚未遍历，重复遍历至多产生重复的新建通知
+                if (m_stWatchers.find(change.Path) == m_stWatchers.end())
+                {
+                    ScanTask task;
+                    task.Path = change.Path;
+                    task.ReportCreated = true;
+                    m_stScanQueue.emplace_back(std::move(task));
+                }
+            }
+            else
+            {
+                RemoveTree(change.Path);
+
+                // 被删除的目录自身的事件会以"目录/目录名"的形式上报，父目录上已经有对应的事件，直接丢弃
+                if (ret < 0 && IsSelfEvent(change.Path))
+                    continue;
+            }
+            kept.emplace_back(std::move(change));
+        }
+        changes = std::move(kept);
+
+        // 单次遍历的目录数有上限，避免大量新建的目录树长时间阻塞RunLoop
+        Walk(kMaxScanPerFlush, created);
+
+        if (!created.empty())
+        {
+            unordered_set<string> known;
+            for (const auto& change : changes)
+                known.insert(change.Path);
+            for (auto& change : created)
+            {
+                if (known.insert(change.Path).second)
+                    changes.emplace_back(std::move(change));
+            }
+        }
+
+        // 遍历中的错误直接在本次一并通知
+        errors.insert(errors.end(), m_stPendingErrors.begin(), m_stPendingErrors.end());
+        m_stPendingErrors.clear();
+
+        // 遍历未完成时让出RunLoop，在下一次迭代中继续
+        if (!m_stScanQueue.empty())
+        {
+            m_stFlushTimer.SetFirstTime(0);
+            m_stFlushTimer.Start();
+            m_stFlushTimer.SetFirstTime(m_ullWindow);
+        }
+        else if (m_stPending.empty())
+            m_stFlushTimer.Stop();
+    }
+
+    for (const auto& error : errors)
+        OnError(error.first, error.second);
+    if (!changes.empty())
+        OnChanges(changes);
+}
@@ -4,18 +4,145 @@
  * @date 2017/11/30
  */
 #include <Moe.UV/RunLoop.hpp>
+#include <Moe.UV/EventHandle.hpp>
+#include <Moe.UV/Stream.hpp>
+#include <Moe.UV/Timer.hpp>
+#include <Moe.UV/Tracing.hpp>
 
 #include <chrono>
-#include <thread>
+#include <vector>
 
 #include "UV.inl"
 
+#ifndef MOE_WINDOWS
+#include <poll.h>
+#endif
+
 using namespace std;
 using namespace moe;
 using namespace UV;
 
 thread_local static RunLoop* t_pRunLoop = nullptr;
 
+//////////////////////////////////////////////////////////////////////////////// RunLoop::StatsContext
+
+struct RunLoop::StatsContext
+{
+    EventHandle Prepare;
+    EventHandle Check;
+
+    uint64_t PrepareTime = 0;
+    uint64_t PollReturnTime = 0;
+    uint64_t CallbackTimeSincePrepare = 0;
+    unsigned CallbackDepth = 0;
+    bool InternalCallback = false;  // 用于排除统计句柄自身的回调
+
+    RunLoopStats Stats;
+
+    StatsContext()
+        : Prepare(EventHandle::Create(EventHandle::EventType::Prepare)),
+        Check(EventHandle::Create(EventHandle::EventType::Check)) {}
+};
+
+//////////////////////////////////////////////////////////////////////////////// RunLoop::ActivityContext
+
+struct RunLoop::ActivityContext
+{
+    EventHandle Prepare;
+    EventHandle Check;
+    bool InPrepare = false;  // 处于prepare阶段，其他prepare回调不应标记忙碌
+
+    ActivityContext()
+        : Prepare(EventHandle::Create(EventHandle::EventType::Prepare)),
+        Check(EventHandle::Create(EventHandle::EventType::Check)) {}
+};
+
+//////////////////////////////////////////////////////////////////////////////// RunLoop::CallbackScope
+
+RunLoop::CallbackScope::CallbackScope(const char* site)noexcept
+    : m_pSite(site)
+{
+    if (Tracing::IsEnabled())
+    {
+        m_bTraced = true;
+        m_ullStart = ::uv_hrtime();
+    }
+
+    auto loop = t_pRunLoop;
+    if (!loop)
+        return;
+    m_pLoop = loop;
+
+    if (loop->m_uActivityTrackers)
+    {
+        m_bTracked = true;
+        m_pPrevSite = loop->m_stCurrentCallback.load(memory_order_relaxed);
+        loop->m_stCurrentCallback.store(site, memory_order_relaxed);
+
+        // I/O回调在check之前执行，因此由第一个回调标记开始忙碌
+        if (loop->m_ullBusySince.load(memory_order_relaxed) == 0)
+        {
+            m_bStamped = true;
+            loop->m_ullBusySince.store(::uv_hrtime(), memory_order_relaxed);
+        }
+    }
+
+    if (loop->m_pStats)
+    {
+        m_bTimed = true;
+        if (loop->m_pStats->CallbackDepth++ == 0 && m_ullStart == 0)
+            m_ullStart = ::uv_hrtime();
+    }
+}
+
+RunLoop::CallbackScope::~CallbackScope()
+{
+    uint64_t now = 0;
+    if (m_bTraced)
+    {
+        now = ::uv_hrtime();
+        Tracing::Record(m_pSite, m_ullStart, now - m_ullStart);
+    }
+
+    if (!m_pLoop)
+        return;
+
+    if (m_bTracked)
+    {
+        m_pLoop->m_stCurrentCallback.store(m_pPrevSite, memory_order_relaxed);
+
+        // prepare阶段之后即进入轮询，由prepare回调标记的忙碌需要撤销，否则空闲时会被误判为卡顿
+        if (m_bStamped && m_pLoop->m_pActivity && m_pLoop->m_pActivity->InPrepare)
+            m_pLoop->m_ullBusySince.store(0, memory_order_relaxed);
+    }
+
+    if (!m_bTimed || !m_pLoop->m_pStats)
+        return;
+
+    // 回调中可能关闭后又重新启用统计，此时计数已经不匹配
+    auto& context = *m_pLoop->m_pStats;
+    if (context.CallbackDepth == 0)
+        return;
+    if (--context.CallbackDepth != 0 || m_ullStart == 0)
+        return;
+    if (now == 0)
+        now = ::uv_hrtime();
+
+    if (context.InternalCallback)
+    {
+        context.InternalCallback = false;
+        return;
+    }
+
+    auto elapsed = now - m_ullStart;
+    context.CallbackTimeSincePrepare += elapsed;
+    context.Stats.CallbackTime.Record(elapsed);
+    context.Stats.TotalCallbackTime += elapsed;
+    ++context.Stats.Callbacks;
+}
+
+//////////////////////////////////////////////////////////////////////////////// RunLoop
+
 RunLoop* RunLoop::GetCurrent()noexcept
 {
     return t_pRunLoop;
@@ -29,6 +156,11 @@ Time::Tick RunLoop::Now()noexcept
     return ::uv_now(self->GetHandle());
 }
 
+uint64_t RunLoop::NowNanos()noexcept
+{
+    return ::uv_hrtime();
+}
+
 void RunLoop::UVClosingHandleWalker(::uv_handle_t* handle, void* arg)noexcept
 {
     RunLoop* self = static_cast<RunLoop*>(arg);
@@ -36,16 +168,34 @@ void RunLoop::UVClosingHandleWalker(::uv_handle_t* handle, void* arg)noexcept
 
     if (!::uv_is_closing(handle))
     {
+        auto owner = InternalHandleOwner::FromData(handle->data);
         if (AsyncHandle::DataToHandle(handle->data))
             ::uv_close(handle, AsyncHandle::OnUVClose);
+        else if (owner)
+            ::uv_close(handle, owner->OnClose);  // 内部句柄，由持有者释放
         else
             ::uv_close(handle, nullptr);  // 外部库共享libuv的句柄
     }
 }
 
+void RunLoop::UVEnumHandleWalker(::uv_handle_t* handle, void* arg)noexcept
+{
+    auto& handles = *static_cast<vector<::uv_handle_t*>*>(arg);
+
+    if (!::uv_is_closing(handle) && AsyncHandle::DataToHandle(handle->data))
+        handles.push_back(handle);
+}
+
 RunLoop::RunLoop(ObjectPool& pool, bool useDefaultLoop)
-    : m_stObjectPool(pool)
+    : m_stObjectPool(pool), m_stCurrentCallback(nullptr), m_ullBusySince(0)
 {
+    for (auto& counter : m_stAllocCounters)
+    {
+        counter.Live.store(0, memory_order_relaxed);
+        counter.Peak.store(0, memory_order_relaxed);
+        counter.Allocs.store(0, memory_order_relaxed);
+    }
+
     if (t_pRunLoop)
         MOE_THROW(InvalidCallException, "RunLoop is already existed");
 
@@ -71,16 +221,16 @@ RunLoop::~RunLoop()
     static const int kMaxLoopTimeout = 5000;
 
     m_bClosing = true;
+    m_pStats.reset();
+    m_pActivity.reset();
 
-    // 关闭所有句柄
+    // 关闭所有句柄，仍有未完成的请求时阻塞在轮询中等待
     auto start = ::uv_now(GetHandle());
     while (::uv_loop_alive(GetHandle()))
     {
         ForceCloseAllHandle();
         ::uv_run(GetHandle(), UV_RUN_ONCE);
 
-        this_thread::yield();
-
         auto now = ::uv_now(GetHandle());
         if (now - start > kMaxLoopTimeout)
             break;  // 超时N秒
@@ -114,16 +264,68 @@ RunLoop::~RunLoop()
 void RunLoop::Run()
 {
     ::uv_run(GetHandle(), UV_RUN_DEFAULT);
+    ClearActivity();
+}
+
+void RunLoop::RunBusyPoll(unsigned spinBudget)
+{
+#ifdef MOE_WINDOWS
+    MOE_UNUSED(spinBudget);
+    MOE_THROW(InvalidCallException, "Not supported");
+#else
+    auto loop = GetHandle();
+    auto budget = static_cast<uint64_t>(spinBudget) * 1000;
+
+    // 后端描述符（epoll/kqueue）在有就绪的I/O时可读，检查它不会消费事件
+    ::pollfd backend;
+    backend.fd = ::uv_backend_fd(loop);
+    backend.events = POLLIN;
+
+    m_bStopRequested = false;
+    while (true)
+    {
+        // 自旋期间不在任何回调中，清除check阶段留下的忙碌标记，否则看门狗会误判为卡顿
+        auto alive = ::uv_run(loop, UV_RUN_NOWAIT);
+        ClearActivity();
+        if (alive == 0 || m_bStopRequested)
+            break;
+
+        auto start = ::uv_hrtime();
+        while (true)
+        {
+            backend.revents = 0;
+            if (::poll(&backend, 1, 0) > 0)
+                break;
+
+            // 定时器到期、存在待处理的回调或Idle句柄时超时为0
+            ::uv_update_time(loop);
+            if (::uv_backend_timeout(loop) == 0)
+                break;
+
+            if (::uv_hrtime() - start >= budget)
+            {
+                ::uv_run(loop, UV_RUN_ONCE);
+                ClearActivity();
+                break;
+            }
+        }
+
+        if (m_bStopRequested)
+            break;
+    }
+#endif
 }
 
 void RunLoop::Stop()noexcept
 {
+    m_bStopRequested = true;
     ::uv_stop(GetHandle());
 }
 
 void RunLoop::RunOnce(bool wait)
 {
     ::uv_run(GetHandle(), wait ? UV_RUN_ONCE : UV_RUN_NOWAIT);
+    ClearActivity();
 }
 
 void RunLoop::ForceCloseAllHandle()noexcept
@@ -131,6 +333,62 @@ void RunLoop::ForceCloseAllHandle()noexcept
     ::uv_walk(GetHandle(), UVClosingHandleWalker, this);
 }
 
+size_t RunLoop::Drain(Time::Tick timeout, const EnumHandlesCallbackType& onStraggler)
+{
+    if (t_pRunLoop != this)
+        MOE_THROW(InvalidCallException, "Drain must be called on the thread of the RunLoop");
+
+    // 截止时间由定时器唤醒轮询，而不是忙等
+    bool expired = false;
+    auto timer = Timer::Create();
+    timer.SetFirstTime(timeout);
+    timer.SetOnTimeCallback([&]() { expired = true; });
+    timer.Start();
+
+    size_t pending = 0;
+    while (true)
+    {
+        pending = DrainStreams();
+        if (pending == 0 || expired)
+            break;
+        ::uv_run(GetHandle(), UV_RUN_ONCE);
+    }
+    timer.Close();
+
+    if (pending != 0 && onStraggler)
+    {
+        EnumHandles([&](AsyncHandle& handle) {
+            if (dynamic_cast<Stream*>(&handle))
+                onStraggler(handle);
+        });
+    }
+
+    // 完成本次关闭的句柄的回调
+    ::uv_run(GetHandle(), UV_RUN_NOWAIT);
+    ClearActivity();
+    return pending;
+}
+
+void RunLoop::EnumHandles(const EnumHandlesCallbackType& cb)
+{
+    if (!cb)
+        MOE_THROW(BadArgumentException, "Callback is empty");
+
+    // 先收集再回调，使得异常可以正常抛出
+    vector<::uv_handle_t*> handles;
+    ::uv_walk(GetHandle(), UVEnumHandleWalker, &handles);
+
+    for (auto handle : handles)
+    {
+        // 句柄内存在关闭回调前不会释放，但对象可能已在之前的回调中被销毁或关闭
+        if (::uv_is_closing(handle))
+            continue;
+        auto self = AsyncHandle::DataToHandle(handle->data);
+        if (self)
+            cb(*self);
+    }
+}
+
 void RunLoop::UpdateTime()noexcept
 {
     ::uv_update_time(GetHandle());
@@ -140,3 +398,234 @@ Time::Tick RunLoop::GetCurrentTime()const noexcept
 {
     return ::uv_now(GetHandle());
 }
+
+void RunLoop::SetStatsEnabled(bool enabled)
+{
+    if (enabled == IsStatsEnabled())
+        return;
+    if (!enabled)
+    {
+        m_pStats.reset();
+        return;
+    }
+
+    unique_ptr<StatsContext> context(new StatsContext());
+
+    // 统计句柄不应阻止循环退出
+    context->Prepare.SetOnEventCallback([this]() { OnStatsPrepare(); });
+    context->Prepare.Start();
+    context->Prepare.Unref();
+    context->Check.SetOnEventCallback([this]() { OnStatsCheck(); });
+    context->Check.Start();
+    context->Check.Unref();
+
+    m_pStats = std::move(context);
+}
+
+RunLoopStats RunLoop::GetStats()const
+{
+    if (!m_pStats)
+        return RunLoopStats();
+    return m_pStats->Stats;
+}
+
+void RunLoop::ResetStats()noexcept
+{
+    if (!m_pStats)
+        return;
+
+    auto& stats = m_pStats->Stats;
+    stats.Iterations = 0;
+    stats.Callbacks = 0;
+    stats.TotalIdleTime = 0;
+    stats.TotalCallbackTime = 0;
+    stats.LoopLag.Reset();
+    stats.IdleTime.Reset();
+    stats.CallbackTime.Reset();
+}
+
+AllocStats RunLoop::GetAllocStats()const noexcept
+{
+    AllocStats ret;
+    for (size_t i = 0; i < static_cast<size_t>(AllocCategory::Count); ++i)
+    {
+        const auto& counter = m_stAllocCounters[i];
+        auto& entry = ret.Categories[i];
+        entry.Live = counter.Live.load(memory_order_relaxed);
+        entry.Peak = counter.Peak.load(memory_order_relaxed);
+        entry.Allocs = counter.Allocs.load(memory_order_relaxed);
+    }
+    return ret;
+}
+
+void RunLoop::ResetAllocPeaks()noexcept
+{
+    for (auto& counter : m_stAllocCounters)
+        counter.Peak.store(counter.Live.load(memory_order_relaxed), memory_order_relaxed);
+}
+
+void RunLoop::RecordAlloc(AllocCategory category, size_t size)noexcept
+{
+    assert(category < AllocCategory::Count);
+    auto& counter = m_stAllocCounters[static_cast<size_t>(category)];
+
+    // 只有RunLoop线程写入，无需原子的读改写
+    auto live = counter.Live.load(memory_order_relaxed) + size;
+    counter.Live.store(live, memory_order_relaxed);
+    if (live > counter.Peak.load(memory_order_relaxed))
+        counter.Peak.store(live, memory_order_relaxed);
+    counter.Allocs.store(counter.Allocs.load(memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+void RunLoop::RecordFree(AllocCategory category, size_t size)noexcept
+{
+    assert(category < AllocCategory::Count);
+    auto& counter = m_stAllocCounters[static_cast<size_t>(category)];
+
+    // 跨RunLoop释放（如RunLoop销毁后重建）时可能不匹配，此时截断为0
+    auto live = counter.Live.load(memory_order_relaxed);
+    counter.Live.store(live >= size ? live - size : 0, memory_order_relaxed);
+}
+
+void RunLoop::OnStatsPrepare()noexcept
+{
+    assert(m_pStats);
+    auto& context = *m_pStats;
+    context.InternalCallback = true;
+
+    // 即将进入轮询，上一次轮询返回后的时间都花费在了各类回调上
+    auto now = ::uv_hrtime();
+    if (context.PollReturnTime != 0)
+        context.Stats.LoopLag.Record(now - context.PollReturnTime);
+    ++context.Stats.Iterations;
+
+    context.PrepareTime = now;
+    context.CallbackTimeSincePrepare = 0;
+}
+
+void RunLoop::OnStatsCheck()noexcept
+{
+    assert(m_pStats);
+    auto& context = *m_pStats;
+    context.InternalCallback = true;
+
+    // 轮询阶段的耗时扣除其中I/O回调的时间即为等待时间
+    auto now = ::uv_hrtime();
+    if (context.PrepareTime == 0)
+        return;
+
+    auto elapsed = now - context.PrepareTime;
+    auto idle = elapsed > context.CallbackTimeSincePrepare ? elapsed - context.CallbackTimeSincePrepare : 0;
+    context.Stats.IdleTime.Record(idle);
+    context.Stats.TotalIdleTime += idle;
+    context.PollReturnTime = context.PrepareTime + idle;
+}
+
+size_t RunLoop::DrainStreams()
+{
+    size_t pending = 0;
+    EnumHandles([&](AsyncHandle& handle) {
+        auto stream = dynamic_cast<Stream*>(&handle);
+        if (!stream)
+            return;
+
+        if (stream->IsListening())
+        {
+            stream->Close();
+            return;
+        }
+
+        if (stream->IsShutdown())
+        {
+            // 数据已全部写出，读端已结束或不再读取时即可关闭
+            if (!stream->IsReadable() || !::uv_is_active(stream->GetHandle()))
+                stream->Close();
+            else
+                ++pending;
+            return;
+        }
+
+        if (!stream->IsShuttingDown())
+        {
+            // Shutdown会排在写屏障之后，屏障未解除时不能直接关闭
+            if (!stream->IsWriteBlocked() && stream->GetWriteQueueSize() == 0)
+            {
+                stream->Close();
+                return;
+            }
+
+            try
+            {
+                stream->Shutdown();
+            }
+            catch (const ExceptionBase&)
+            {
+                stream->Close();
+                return;
+            }
+        }
+        ++pending;
+    });
+    return pending;
+}
+
+void RunLoop::ClearActivity()noexcept
+{
+    // uv_run返回后check阶段的忙碌标记以及关闭回调留下的标记均不再有效
+    // 在回调中嵌套运行循环时仍处于外层回调，保留标记
+    if (!m_pActivity || m_stCurrentCallback.load(memory_order_relaxed) != nullptr)
+        return;
+    m_pActivity->InPrepare = false;
+    m_ullBusySince.store(0, memory_order_relaxed);
+}
+
+void RunLoop::SetActivityTrackingEnabled(bool enabled)
+{
+    if (!enabled)
+    {
+        assert(m_uActivityTrackers > 0);
+        if (m_uActivityTrackers == 0 || --m_uActivityTrackers != 0)
+            return;
+
+        m_pActivity.reset();
+        m_stCurrentCallback.store(nullptr, memory_order_relaxed);
+        m_ullBusySince.store(0, memory_order_relaxed);
+        return;
+    }
+
+    if (m_uActivityTrackers++ != 0)
+        return;
+
+    try
+    {
+        unique_ptr<ActivityContext> context(new ActivityContext());
+
+        // 进入轮询前清除忙碌标记，轮询返回后若尚未被回调标记则在此标记
+        // prepare按创建顺序逆序执行，先于本句柄创建的prepare在其后执行，因此标记prepare阶段直到check
+        auto activity = context.get();
+        context->Prepare.SetOnEventCallback([this, activity]() {
+            if (m_pStats)
+                m_pStats->InternalCallback = true;
+            activity->InPrepare = true;
+            m_ullBusySince.store(0, memory_order_relaxed);
+        });
+        context->Prepare.Start();
+        context->Prepare.Unref();
+        context->Check.SetOnEventCallback([this, activity]() {
+            if (m_pStats)
+                m_pStats->InternalCallback = true;
+            activity->InPrepare = false;
+            if (m_ullBusySince.load(memory_order_relaxed) == 0)
+                m_ullBusySince.store(::uv_hrtime(), memory_order_relaxed);
+        });
+        context->Check.Start();
+        context->Check.Unref();
+
+        m_pActivity = std::move(context);
+    }
+    catch (...)
+    {
+        --m_uActivityTrackers;
+        throw;
+    }
+}
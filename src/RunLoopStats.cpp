@@ -0,0 +1,144 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include <Moe.UV/RunLoopStats.hpp>
+
+#include <cassert>
+#include <algorithm>
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+
+namespace
+{
+    unsigned HighestBit(uint64_t value)noexcept
+    {
+        assert(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+        unsigned ret = 0;
+        while (value >>= 1)
+            ++ret;
+        return ret;
+#endif
+    }
+}
+
+const unsigned LatencyHistogram::kSubBucketBits;
+const uint64_t LatencyHistogram::kSubBucketCount;
+const unsigned LatencyHistogram::kMaxMagnitude;
+const uint64_t LatencyHistogram::kMaxValue;
+
+LatencyHistogram::LatencyHistogram()
+    : m_stBuckets(GetBucketIndex(kMaxValue) + 1)
+{
+}
+
+uint64_t LatencyHistogram::GetPercentile(double percentile)const noexcept
+{
+    if (m_ullCount == 0)
+        return 0;
+
+    percentile = std::min(std::max(percentile, 0.), 100.);
+    auto target = static_cast<uint64_t>(percentile / 100. * static_cast<double>(m_ullCount) + 0.5);
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_stBuckets.size(); ++i)
+    {
+        seen += m_stBuckets[i];
+        if (seen >= target)
+            return std::min(GetBucketUpperBound(i), m_ullMax);
+    }
+    return m_ullMax;
+}
+
+void LatencyHistogram::Record(uint64_t value)noexcept
+{
+    value = std::min(value, kMaxValue);
+
+    ++m_stBuckets[GetBucketIndex(value)];
+    if (m_ullCount == 0 || value < m_ullMin)
+        m_ullMin = value;
+    m_ullMax = std::max(m_ullMax, value);
+    m_ullSum += value;
+    ++m_ullCount;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& rhs)noexcept
+{
+    if (rhs.m_ullCount == 0)
+        return;
+
+    assert(m_stBuckets.size() == rhs.m_stBuckets.size());
+    for (size_t i = 0; i < m_stBuckets.size(); ++i)
+        m_stBuckets[i] += rhs.m_stBuckets[i];
+
+    m_ullMin = m_ullCount == 0 ? rhs.m_ullMin : std::min(m_ullMin, rhs.m_ullMin);
+    m_ullMax = std::max(m_ullMax, rhs.m_ullMax);
+    m_ullSum += rhs.m_ullSum;
+    m_ullCount += rhs.m_ullCount;
+}
+
+void LatencyHistogram::Reset()noexcept
+{
+    std::fill(m_stBuckets.begin(), m_stBuckets.end(), 0);
+    m_ullCount = 0;
+    m_ullMin = 0;
+    m_ullMax = 0;
+    m_ullSum = 0;
+}
+
+size_t LatencyHistogram::GetBucketIndex(uint64_t value)noexcept
+{
+    // 小于kSubBucketCount的值精确记录，之后每个数量级kSubBucketCount个桶
+    if (value < kSubBucketCount)
+        return static_cast<size_t>(value);
+
+    auto shift = HighestBit(value) - kSubBucketBits;
+    return static_cast<size_t>((shift + 1) * kSubBucketCount + ((value >> shift) - kSubBucketCount));
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(size_t index)noexcept
+{
+    if (index < kSubBucketCount)
+        return index;
+
+    auto shift = index / kSubBucketCount - 1;
+    auto sub = index % kSubBucketCount + kSubBucketCount;
+    return ((sub + 1) << shift) - 1;
+}
+
+const char* moe::UV::GetAllocCategoryName(AllocCategory category)noexcept
+{
+    switch (category)
+    {
+        case AllocCategory::Handle:
+            return "handle";
+        case AllocCategory::ReadBuffer:
+            return "read_buffer";
+        case AllocCategory::WriteCopy:
+            return "write_copy";
+        case AllocCategory::Request:
+            return "request";
+        case AllocCategory::Dns:
+            return "dns";
+        case AllocCategory::Work:
+            return "work";
+        default:
+            assert(false);
+            return "unknown";
+    }
+}
+
+size_t AllocStats::GetTotalLive()const noexcept
+{
+    size_t ret = 0;
+    for (const auto& entry : Categories)
+        ret += entry.Live;
+    return ret;
+}
@@ -0,0 +1,480 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include <Moe.UV/SharedMemoryStream.hpp>
+
+#ifdef MOE_LINUX
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+
+#include "UV.inl"
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+
+namespace
+{
+    const uint32_t kMagic = 0x4D534D53;  // "SMSM"
+    const uint32_t kPadMarker = 0xFFFFFFFFu;
+    const size_t kHeaderSize = 4096;
+    const unsigned kMfdCloexec = 1u;  // MFD_CLOEXEC，旧版glibc没有memfd_create的声明
+
+    struct ControlBlock
+    {
+        uint32_t Magic;
+        uint32_t Reserved;
+        uint64_t Capacity;
+    };
+
+    size_t AlignRecord(size_t length)noexcept
+    {
+        return (sizeof(uint32_t) + length + 7) & ~static_cast<size_t>(7);
+    }
+}
+
+/**
+ * @brief 单个方向的环形缓冲区头部
+ *
+ * 生产者和消费者各自写入的字段位于不同缓存行，避免伪共享。
+ */
+struct SharedMemoryStream::RingHeader
+{
+    alignas(64) std::atomic<uint64_t> Head;  // 生产者写入
+    std::atomic<uint32_t> ProducerWaiting;
+    std::atomic<uint32_t> ProducerClosed;
+
+    alignas(64) std::atomic<uint64_t> Tail;  // 消费者写入
+    std::atomic<uint32_t> ConsumerSleeping;
+    std::atomic<uint32_t> ConsumerClosed;
+};
+
+const size_t SharedMemoryStream::kDefaultCapacity;
+const size_t SharedMemoryStream::kMaxBatchSize;
+
+SharedMemoryStream::Descriptors SharedMemoryStream::Allocate(size_t capacity)
+{
+    // 头部第一个RingHeader大小的位置存放ControlBlock，之后是两个方向的RingHeader
+    static_assert(sizeof(ControlBlock) <= sizeof(RingHeader) && 3 * sizeof(RingHeader) <= kHeaderSize,
+        "Header too large");
+
+    if (capacity < 4096 || (capacity & (capacity - 1)) != 0)
+        MOE_THROW(BadArgumentException, "Capacity must be a power of 2 and at least 4096");
+
+    Descriptors ret;
+    try
+    {
+        ret.Memory = static_cast<int>(::syscall(SYS_memfd_create, "moe-shm-stream", kMfdCloexec));
+        if (ret.Memory < 0)
+            MOE_THROW(ApiException, "memfd_create error {0}", errno);
+
+        auto size = kHeaderSize + 2 * capacity;
+        if (::ftruncate(ret.Memory, static_cast<off_t>(size)) < 0)
+            MOE_THROW(ApiException, "ftruncate error {0}", errno);
+
+        auto header = ::mmap(nullptr, kHeaderSize, PROT_READ | PROT_WRITE, MAP_SHARED, ret.Memory, 0);
+        if (header == MAP_FAILED)
+            MOE_THROW(ApiException, "mmap error {0}", errno);
+
+        auto control = static_cast<ControlBlock*>(header);
+        control->Magic = kMagic;
+        control->Reserved = 0;
+        control->Capacity = capacity;
+
+        auto rings = reinterpret_cast<RingHeader*>(static_cast<uint8_t*>(header) + sizeof(RingHeader));
+        for (size_t i = 0; i < 2; ++i)
+        {
+            auto ring = new(&rings[i]) RingHeader();
+            assert(ring->Head.is_lock_free());
+            ring->Head.store(0, memory_order_relaxed);
+            ring->ProducerWaiting.store(0, memory_order_relaxed);
+            ring->ProducerClosed.store(0, memory_order_relaxed);
+            ring->Tail.store(0, memory_order_relaxed);
+            ring->ConsumerSleeping.store(0, memory_order_relaxed);
+            ring->ConsumerClosed.store(0, memory_order_relaxed);
+        }
+        ::munmap(header, kHeaderSize);
+
+        for (auto& fd : ret.Notify)
+        {
+            fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (fd < 0)
+                MOE_THROW(ApiException, "eventfd error {0}", errno);
+        }
+    }
+    catch (...)
+    {
+        Release(ret);
+        throw;
+    }
+    return ret;
+}
+
+void SharedMemoryStream::Release(Descriptors& fds)noexcept
+{
+    if (fds.Memory >= 0)
+        ::close(fds.Memory);
+    for (auto& fd : fds.Notify)
+    {
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+    }
+    fds.Memory = -1;
+}
+
+SharedMemoryStream::SharedMemoryStream(const Descriptors& fds, unsigned side)
+    : m_iLocalFd(side < 2 ? ::dup(fds.Notify[side]) : -1), m_stPoll([this, side]() {
+        // 复制一份文件描述符，使同一RunLoop上的两个端点也能各自持有Poll
+        if (side >= 2)
+            MOE_THROW(BadArgumentException, "Invalid side");
+        if (m_iLocalFd < 0)
+            MOE_THROW(ApiException, "dup error {0}", errno);
+
+        try
+        {
+            return Poll::Create(m_iLocalFd);
+        }
+        catch (...)
+        {
+            ::close(m_iLocalFd);
+            throw;
+        }
+    }())
+{
+    try
+    {
+        m_iRemoteFd = ::dup(fds.Notify[1 - side]);
+        if (m_iRemoteFd < 0)
+            MOE_THROW(ApiException, "dup error {0}", errno);
+        m_iMemoryFd = ::dup(fds.Memory);
+        if (m_iMemoryFd < 0)
+            MOE_THROW(ApiException, "dup error {0}", errno);
+
+        struct stat st;
+        if (::fstat(m_iMemoryFd, &st) < 0)
+            MOE_THROW(ApiException, "fstat error {0}", errno);
+        m_uMappingSize = static_cast<size_t>(st.st_size);
+        if (m_uMappingSize < kHeaderSize)
+            MOE_THROW(BadFormatException, "Bad shared memory size");
+
+        auto mapping = ::mmap(nullptr, m_uMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_iMemoryFd, 0);
+        if (mapping == MAP_FAILED)
+            MOE_THROW(ApiException, "mmap error {0}", errno);
+        m_pMapping = mapping;
+
+        auto base = static_cast<uint8_t*>(m_pMapping);
+        auto control = reinterpret_cast<const ControlBlock*>(base);
+        if (control->Magic != kMagic || control->Capacity == 0 || kHeaderSize + 2 * control->Capacity != m_uMappingSize)
+            MOE_THROW(BadFormatException, "Bad shared memory header");
+        m_uCapacity = static_cast<size_t>(control->Capacity);
+
+        auto rings = reinterpret_cast<RingHeader*>(base + sizeof(RingHeader));
+        m_pTx = &rings[side];
+        m_pRx = &rings[1 - side];
+        m_pTxData = base + kHeaderSize + side * m_uCapacity;
+        m_pRxData = base + kHeaderSize + (1 - side) * m_uCapacity;
+
+        m_stPoll.SetOnEventCallback([this](int status, int events) { OnEvent(status, events); });
+        m_stPoll.Start(Poll::EVENT_READABLE);
+    }
+    catch (...)
+    {
+        m_stPoll.Close();
+        if (m_pMapping)
+            ::munmap(m_pMapping, m_uMappingSize);
+        if (m_iMemoryFd >= 0)
+            ::close(m_iMemoryFd);
+        if (m_iRemoteFd >= 0)
+            ::close(m_iRemoteFd);
+        if (m_iLocalFd >= 0)
+            ::close(m_iLocalFd);
+        throw;
+    }
+}
+
+SharedMemoryStream::~SharedMemoryStream()
+{
+    Close();
+
+    ::munmap(m_pMapping, m_uMappingSize);
+    ::close(m_iMemoryFd);
+    ::close(m_iRemoteFd);
+    ::close(m_iLocalFd);
+}
+
+void SharedMemoryStream::Write(BytesView buf)
+{
+    if (m_bClosed)
+        MOE_THROW(InvalidCallException, "Stream is closed");
+    if (buf.GetSize() > GetMaxMessageSize())
+        MOE_THROW(BadArgumentException, "Message too large");
+
+    // 对端已关闭，与写入已关闭的管道一样丢弃数据
+    if (m_pTx->ConsumerClosed.load(memory_order_acquire))
+        return;
+
+    if (m_stQueue.empty() && Push(buf))
+        return;
+
+    m_stQueue.emplace_back(buf.GetBuffer(), buf.GetBuffer() + buf.GetSize());
+    m_uQueuedBytes += buf.GetSize();
+    FlushQueue();
+}
+
+bool SharedMemoryStream::TryWrite(BytesView buf)
+{
+    if (m_bClosed)
+        MOE_THROW(InvalidCallException, "Stream is closed");
+    if (buf.GetSize() > GetMaxMessageSize())
+        MOE_THROW(BadArgumentException, "Message too large");
+
+    if (m_pTx->ConsumerClosed.load(memory_order_acquire))
+        return true;
+    return m_stQueue.empty() && Push(buf);
+}
+
+void SharedMemoryStream::StartRead()
+{
+    if (m_bClosed)
+        MOE_THROW(InvalidCallException, "Stream is closed");
+    if (m_bReading || m_bEof)
+        return;
+
+    // 停止读取期间对端不会唤醒本端，通过自身的eventfd触发一次处理
+    m_bReading = true;
+    Signal(m_iLocalFd);
+}
+
+void SharedMemoryStream::StopRead()noexcept
+{
+    m_bReading = false;
+    m_pRx->ConsumerSleeping.store(0, memory_order_relaxed);
+}
+
+void SharedMemoryStream::Close()noexcept
+{
+    if (m_bClosed)
+        return;
+    m_bClosed = true;
+    m_bReading = false;
+
+    m_stQueue.clear();
+    m_uQueuedBytes = 0;
+
+    m_pTx->ProducerClosed.store(1, memory_order_release);
+    m_pRx->ConsumerClosed.store(1, memory_order_release);
+    Signal(m_iRemoteFd);
+
+    m_stPoll.Close();
+}
+
+void SharedMemoryStream::OnData(BytesView data)
+{
+    if (m_pOnData)
+        m_pOnData(data);
+}
+
+void SharedMemoryStream::OnEof()
+{
+    if (m_pOnEof)
+        m_pOnEof();
+}
+
+void SharedMemoryStream::OnError(int error)
+{
+    if (m_pOnError)
+        m_pOnError(error);
+}
+
+bool SharedMemoryStream::Push(BytesView buf)noexcept
+{
+    auto length = static_cast<uint32_t>(buf.GetSize());
+    auto record = AlignRecord(length);
+
+    // 单生产者，Head只由本端写入
+    auto head = m_pTx->Head.load(memory_order_relaxed);
+    auto tail = m_pTx->Tail.load(memory_order_acquire);
+    auto offset = static_cast<size_t>(head & (m_uCapacity - 1));
+
+    // 尾部空间不足时填充标记并回绕，记录始终连续存放
+    auto padding = m_uCapacity - offset < record ? m_uCapacity - offset : 0;
+    if (m_uCapacity - static_cast<size_t>(head - tail) < padding + record)
+        return false;
+
+    if (padding)
+    {
+        ::memcpy(m_pTxData + offset, &kPadMarker, sizeof(kPadMarker));
+        head += padding;
+        offset = 0;
+    }
+
+    ::memcpy(m_pTxData + offset, &length, sizeof(length));
+    if (length > 0)
+        ::memcpy(m_pTxData + offset + sizeof(length), buf.GetBuffer(), length);
+    m_pTx->Head.store(head + record, memory_order_release);
+
+    // 仅在消费者声明休眠时才唤醒
+    atomic_thread_fence(memory_order_seq_cst);
+    if (m_pTx->ConsumerSleeping.load(memory_order_relaxed) &&
+        m_pTx->ConsumerSleeping.exchange(0, memory_order_acq_rel))
+    {
+        Signal(m_iRemoteFd);
+    }
+    return true;
+}
+
+void SharedMemoryStream::FlushQueue()noexcept
+{
+    if (m_pTx->ConsumerClosed.load(memory_order_acquire))
+    {
+        m_stQueue.clear();
+        m_uQueuedBytes = 0;
+    }
+
+    bool waiting = false;
+    while (!m_stQueue.empty())
+    {
+        const auto& front = m_stQueue.front();
+        if (!Push(BytesView(front.data(), front.size())))
+        {
+            if (waiting)
+                return;
+
+            // 先声明等待再重试一次，保证不会错过对端的唤醒
+            m_pTx->ProducerWaiting.store(1, memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+            waiting = true;
+            continue;
+        }
+
+        m_uQueuedBytes -= front.size();
+        m_stQueue.pop_front();
+    }
+
+    m_pTx->ProducerWaiting.store(0, memory_order_relaxed);
+}
+
+bool SharedMemoryStream::Drain()
+{
+    auto tail = m_pRx->Tail.load(memory_order_relaxed);
+    size_t count = 0;
+    bool more = false;
+
+    while (m_bReading)
+    {
+        auto head = m_pRx->Head.load(memory_order_acquire);
+        if (head == tail)
+        {
+            if (m_pRx->ProducerClosed.load(memory_order_acquire) &&
+                m_pRx->Head.load(memory_order_acquire) == tail)
+            {
+                m_bReading = false;
+                m_bEof = true;
+                break;
+            }
+
+            // 声明休眠后再检查一次，保证不会错过生产者的写入
+            m_pRx->ConsumerSleeping.store(1, memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+            if (m_pRx->Head.load(memory_order_acquire) != tail)
+            {
+                m_pRx->ConsumerSleeping.store(0, memory_order_relaxed);
+                continue;
+            }
+            break;
+        }
+
+        if (count >= kMaxBatchSize)
+        {
+            more = true;
+            break;
+        }
+
+        auto offset = static_cast<size_t>(tail & (m_uCapacity - 1));
+        uint32_t length = 0;
+        ::memcpy(&length, m_pRxData + offset, sizeof(length));
+        if (length == kPadMarker)
+        {
+            tail += m_uCapacity - offset;
+            m_pRx->Tail.store(tail, memory_order_release);
+            continue;
+        }
+
+        auto record = AlignRecord(length);
+        if (length > GetMaxMessageSize() || record > static_cast<size_t>(head - tail))
+        {
+            // 共享内存被破坏，无法继续
+            m_bReading = false;
+            OnError(UV_EPROTO);
+            break;
+        }
+
+        // 回调返回后才释放空间，保证数据在回调期间不被覆盖
+        MOE_UV_CATCH_ALL_BEGIN
+            OnData(BytesView(m_pRxData + offset + sizeof(length), length));
+        MOE_UV_CATCH_ALL_END
+
+        tail += record;
+        m_pRx->Tail.store(tail, memory_order_release);
+        ++count;
+    }
+
+    // 批量释放空间后统一唤醒等待中的生产者
+    if (count > 0 && !m_pRx->ConsumerClosed.load(memory_order_relaxed))
+    {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (m_pRx->ProducerWaiting.load(memory_order_relaxed) &&
+            m_pRx->ProducerWaiting.exchange(0, memory_order_acq_rel))
+        {
+            Signal(m_iRemoteFd);
+        }
+    }
+    return more;
+}
+
+void SharedMemoryStream::Signal(int fd)noexcept
+{
+    // 计数器溢出时返回EAGAIN，此时对端必然处于可读状态，忽略即可
+    uint64_t one = 1;
+    auto ret = ::write(fd, &one, sizeof(one));
+    MOE_UNUSED(ret);
+}
+
+void SharedMemoryStream::OnEvent(int status, int events)
+{
+    MOE_UNUSED(events);
+
+    if (status < 0)
+    {
+        OnError(status);
+        return;
+    }
+
+    uint64_t value = 0;
+    auto ret = ::read(m_iLocalFd, &value, sizeof(value));
+    MOE_UNUSED(ret);
+
+    if (!m_stQueue.empty() || m_pTx->ConsumerClosed.load(memory_order_acquire))
+        FlushQueue();
+
+    if (m_bReading && !m_bClosed)
+    {
+        if (Drain())
+            Signal(m_iLocalFd);  // 让出RunLoop，下一轮继续处理
+        else if (m_bEof && !m_bClosed)
+            OnEof();
+    }
+}
+
+#endif
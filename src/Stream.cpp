@@ -4,9 +4,15 @@
  * @date 2018/9/2
  */
 #include <Moe.UV/Stream.hpp>
+#include <Moe.Core/Pal.hpp>
 
 #include "UV.inl"
 
+#ifdef MOE_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 using namespace moe;
 using namespace UV;
@@ -14,17 +20,403 @@ using namespace UV;
 struct UVShutdownRequest
 {
     ::uv_shutdown_t Request;
+    AllocAccount Account { AllocCategory::Request, sizeof(UVShutdownRequest) };
 };
 
 struct UVWriteRequest
 {
     ::uv_write_t Request;
     ::uv_buf_t BufferDesc;
+    AllocAccount Account { AllocCategory::Request, sizeof(UVWriteRequest) };
+    bool Barrier = false;
 
-    UniquePooledObject<void> CopiedBuffer;
+    PooledBuffer CopiedBuffer;
     Stream::OnWriteCallbackType OnWrite;
 };
 
+//////////////////////////////////////////////////////////////////////////////// Stream::RelayContext
+
+struct Stream::RelayContext :
+    public InternalHandleOwner
+{
+    static const size_t kSpliceChunkSize = 64 * 1024;
+    static const unsigned kMaxPumpRounds = 16;  // 单次事件最多搬运的轮数，避免饿死其他句柄
+
+    AllocAccount Account { AllocCategory::Request, sizeof(RelayContext) };
+
+    ::uv_loop_t* Loop = nullptr;
+    ::uv_stream_t* Source = nullptr;  // 结束后置空
+    ::uv_stream_t* Target = nullptr;  // 结束后置空
+    OnRelayEndCallbackType OnEnd;
+
+    bool Finished = false;
+    size_t Pending = 0;  // 未回调的写请求及屏障，归零前不能释放
+    size_t QueuedBytes = 0;
+    bool Paused = false;
+
+    // splice模式
+    bool Splice = false;
+    bool BarrierHeld = false;
+    int PipeFds[2] = { -1, -1 };
+    int SourceFd = -1;  // 复制的句柄，保证转发过程中句柄不被复用
+    int TargetFd = -1;
+    size_t Buffered = 0;  // 内核管道中的数据量
+    ::uv_poll_t SourcePoll;
+    ::uv_poll_t TargetPoll;
+    bool SourcePollInited = false;  // 关闭回调后复位
+    bool TargetPollInited = false;
+
+    RelayContext()noexcept
+        : InternalHandleOwner(OnUVPollClose) {}
+
+    ~RelayContext()
+    {
+#ifdef MOE_LINUX
+        for (auto fd : { PipeFds[0], PipeFds[1], SourceFd, TargetFd })
+        {
+            if (fd >= 0)
+                ::close(fd);
+        }
+#endif
+    }
+
+    Stream* GetSource()noexcept { return Source ? GetSelf<Stream>(Source) : nullptr; }
+    Stream* GetTarget()noexcept { return Target ? GetSelf<Stream>(Target) : nullptr; }
+
+    static void Forward(RelayContext* context, PooledBuffer&& buffer, size_t size)noexcept;
+    static void OnTargetWritten(RelayContext* context, size_t size, int status)noexcept;
+    static void Finish(RelayContext* context, int status)noexcept;
+    static void TryFree(RelayContext* context)noexcept;
+    static void OnUVPollClose(::uv_handle_t* handle)noexcept;
+
+#ifdef MOE_LINUX
+    static void OnBarrier(RelayContext* context, ::uv_stream_t* target, int status)noexcept;
+    static void OnUVPoll(::uv_poll_t* handle, int status, int events)noexcept;
+    static int StartSplice(RelayContext* context)noexcept;
+    static void Pump(RelayContext* context)noexcept;
+    static void Watch(RelayContext* context, bool source)noexcept;
+#endif
+};
+
+const size_t Stream::RelayContext::kSpliceChunkSize;
+const unsigned Stream::RelayContext::kMaxPumpRounds;
+
+void Stream::RelayContext::Forward(RelayContext* context, PooledBuffer&& buffer, size_t size)noexcept
+{
+    auto target = context->GetTarget();
+    assert(target);
+
+    try
+    {
+        // 读缓冲区的所有权直接移交给写请求
+        MOE_UV_NEW(UVWriteRequest);
+        object->CopiedBuffer = std::move(buffer);
+        object->BufferDesc = ::uv_buf_init(static_cast<char*>(object->CopiedBuffer.Get()), static_cast<unsigned>(size));
+        object->OnWrite = [context, size](int status) { OnTargetWritten(context, size, status); };
+
+        auto& req = object->Request;
+        req.data = object.release();
+
+        ++context->Pending;
+        context->QueuedBytes += size;
+        try
+        {
+            target->SubmitWrite(context->Target, &req);
+        }
+        catch (...)
+        {
+            --context->Pending;
+            context->QueuedBytes -= size;
+            throw;
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        Finish(context, UV_ENOMEM);
+        return;
+    }
+    catch (const moe::ExceptionBase&)
+    {
+        Finish(context, UV_EPIPE);
+        return;
+    }
+
+    if (context->QueuedBytes > kRelayHighWaterMark)
+    {
+        auto source = context->GetSource();
+        assert(source);
+        source->StopRead();
+        context->Paused = true;
+    }
+}
+
+void Stream::RelayContext::OnTargetWritten(RelayContext* context, size_t size, int status)noexcept
+{
+    assert(context->Pending > 0);
+    --context->Pending;
+    context->QueuedBytes -= size;
+
+    if (context->Finished)
+    {
+        TryFree(context);
+        return;
+    }
+
+    if (status != 0)
+    {
+        Finish(context, status);
+        return;
+    }
+
+    if (context->Paused && context->QueuedBytes <= kRelayHighWaterMark / 2)
+    {
+        auto source = context->GetSource();
+        assert(source);
+        context->Paused = false;
+
+        auto r = ::uv_read_start(context->Source, OnUVAllocBuffer, OnUVRead);
+        if (r < 0 && r != UV_EALREADY)
+            Finish(context, r);
+    }
+}
+
+void Stream::RelayContext::Finish(RelayContext* context, int status)noexcept
+{
+    if (context->Finished)
+        return;
+    context->Finished = true;
+
+    auto source = context->GetSource();
+    auto target = context->GetTarget();
+    if (source && source->m_pRelay == context)
+    {
+        source->m_pRelay = nullptr;
+        if (!context->Splice)
+            source->StopRead();
+    }
+    if (target && target->m_pRelayFrom == context)
+        target->m_pRelayFrom = nullptr;
+
+    if (context->BarrierHeld)
+    {
+        context->BarrierHeld = false;
+        if (target)
+            target->ReleaseWriteBarrier();
+    }
+
+    context->Source = nullptr;
+    context->Target = nullptr;
+
+    auto sourcePoll = reinterpret_cast<::uv_handle_t*>(&context->SourcePoll);
+    auto targetPoll = reinterpret_cast<::uv_handle_t*>(&context->TargetPoll);
+    if (context->SourcePollInited && !::uv_is_closing(sourcePoll))
+        ::uv_poll_stop(&context->SourcePoll);
+    if (context->TargetPollInited && !::uv_is_closing(targetPoll))
+        ::uv_poll_stop(&context->TargetPoll);
+
+    auto cb = std::move(context->OnEnd);
+    if (cb)
+    {
+        MOE_UV_CATCH_ALL_BEGIN
+            cb(static_cast<uv_errno_t>(status));
+        MOE_UV_CATCH_ALL_END
+    }
+
+    TryFree(context);
+}
+
+void Stream::RelayContext::TryFree(RelayContext* context)noexcept
+{
+    if (!context->Finished || context->Pending > 0)
+        return;
+
+    // 轮询句柄需要异步关闭，关闭回调中再次尝试释放，被RunLoop强制关闭时已在关闭中
+    auto sourcePoll = reinterpret_cast<::uv_handle_t*>(&context->SourcePoll);
+    auto targetPoll = reinterpret_cast<::uv_handle_t*>(&context->TargetPoll);
+    if (context->SourcePollInited && !::uv_is_closing(sourcePoll))
+        ::uv_close(sourcePoll, OnUVPollClose);
+    if (context->TargetPollInited && !::uv_is_closing(targetPoll))
+        ::uv_close(targetPoll, OnUVPollClose);
+
+    if (!context->SourcePollInited && !context->TargetPollInited)
+    {
+        UniquePooledObject<RelayContext> p;
+        p.reset(context);
+    }
+}
+
+void Stream::RelayContext::OnUVPollClose(::uv_handle_t* handle)noexcept
+{
+    auto context = static_cast<RelayContext*>(FromData(handle->data));
+    if (handle == reinterpret_cast<::uv_handle_t*>(&context->SourcePoll))
+        context->SourcePollInited = false;
+    else
+        context->TargetPollInited = false;
+
+    // 被RunLoop强制关闭时转发尚未结束，之后也不会再有轮询事件驱动，直接结束
+    if (!context->Finished)
+        Finish(context, UV_ECANCELED);
+    else
+        TryFree(context);
+}
+
+#ifdef MOE_LINUX
+void Stream::RelayContext::OnBarrier(RelayContext* context, ::uv_stream_t* target, int status)noexcept
+{
+    assert(context->Pending > 0);
+    --context->Pending;
+
+    if (status != 0)
+    {
+        // Finish内部已会尝试释放，仅在已完成时单独释放
+        if (!context->Finished)
+            Finish(context, status);
+        else
+            TryFree(context);
+        return;
+    }
+
+    // 屏障回调时目标句柄依旧有效
+    if (context->Finished)
+    {
+        auto self = GetSelf<Stream>(target);
+        if (self)
+            self->ReleaseWriteBarrier();
+        TryFree(context);
+        return;
+    }
+
+    context->BarrierHeld = true;
+
+    auto r = StartSplice(context);
+    if (r < 0)
+        Finish(context, r);
+    else
+        Pump(context);
+}
+
+void Stream::RelayContext::OnUVPoll(::uv_poll_t* handle, int status, int events)noexcept
+{
+    MOE_UNUSED(status);
+    MOE_UNUSED(events);
+
+    // 出错时交由splice返回实际的错误
+    auto context = static_cast<RelayContext*>(FromData(handle->data));
+    if (!context->Finished)
+        Pump(context);
+}
+
+int Stream::RelayContext::StartSplice(RelayContext* context)noexcept
+{
+    ::uv_os_fd_t source, target;
+    auto r = ::uv_fileno(reinterpret_cast<::uv_handle_t*>(context->Source), &source);
+    if (r < 0)
+        return r;
+    r = ::uv_fileno(reinterpret_cast<::uv_handle_t*>(context->Target), &target);
+    if (r < 0)
+        return r;
+
+    context->SourceFd = ::fcntl(source, F_DUPFD_CLOEXEC, 0);
+    if (context->SourceFd < 0)
+        return -errno;
+    context->TargetFd = ::fcntl(target, F_DUPFD_CLOEXEC, 0);
+    if (context->TargetFd < 0)
+        return -errno;
+    if (::pipe2(context->PipeFds, O_NONBLOCK | O_CLOEXEC) != 0)
+        return -errno;
+
+    r = ::uv_poll_init(context->Loop, &context->SourcePoll, context->SourceFd);
+    if (r < 0)
+        return r;
+    context->SourcePoll.data = ToData(context);
+    context->SourcePollInited = true;
+
+    r = ::uv_poll_init(context->Loop, &context->TargetPoll, context->TargetFd);
+    if (r < 0)
+        return r;
+    context->TargetPoll.data = ToData(context);
+    context->TargetPollInited = true;
+    return 0;
+}
+
+void Stream::RelayContext::Pump(RelayContext* context)noexcept
+{
+    for (unsigned round = 0; round < kMaxPumpRounds; ++round)
+    {
+        // 管道为空时才从源读取，使得内核管道本身充当背压缓冲区
+        if (context->Buffered == 0)
+        {
+            auto n = ::splice(context->SourceFd, nullptr, context->PipeFds[1], nullptr, kSpliceChunkSize,
+                SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (n > 0)
+                context->Buffered = static_cast<size_t>(n);
+            else if (n == 0)
+            {
+                Finish(context, 0);
+                return;
+            }
+            else if (errno == EINTR)
+                continue;
+            else if (errno == EAGAIN)
+            {
+                Watch(context, true);
+                return;
+            }
+            else
+            {
+                Finish(context, -errno);
+                return;
+            }
+        }
+
+        auto n = ::splice(context->PipeFds[0], nullptr, context->TargetFd, nullptr, context->Buffered,
+            SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (n > 0)
+            context->Buffered -= static_cast<size_t>(n);
+        else if (n < 0 && errno == EINTR)
+            continue;
+        else if (n < 0 && errno == EAGAIN)
+        {
+            Watch(context, false);
+            return;
+        }
+        else
+        {
+            Finish(context, n < 0 ? -errno : UV_EPIPE);
+            return;
+        }
+    }
+
+    // 让出RunLoop，轮询为水平触发，下一次迭代会继续
+    Watch(context, context->Buffered == 0);
+}
+
+void Stream::RelayContext::Watch(RelayContext* context, bool source)noexcept
+{
+    // 轮询句柄已被RunLoop强制关闭，等待关闭回调结束转发
+    if (::uv_is_closing(reinterpret_cast<::uv_handle_t*>(&context->SourcePoll)) ||
+        ::uv_is_closing(reinterpret_cast<::uv_handle_t*>(&context->TargetPoll)))
+        return;
+
+    int r;
+    if (source)
+    {
+        ::uv_poll_stop(&context->TargetPoll);
+        r = ::uv_poll_start(&context->SourcePoll, UV_READABLE, OnUVPoll);
+    }
+    else
+    {
+        ::uv_poll_stop(&context->SourcePoll);
+        r = ::uv_poll_start(&context->TargetPoll, UV_WRITABLE, OnUVPoll);
+    }
+
+    if (r < 0)
+        Finish(context, r);
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////////// Stream
+
 void Stream::OnUVShutdown(::uv_shutdown_s* request, int status)noexcept
 {
     UniquePooledObject<UVShutdownRequest> owner;
@@ -44,6 +436,8 @@ void Stream::OnUVShutdown(::uv_shutdown_s* request, int status)noexcept
     }
     else
     {
+        self->m_bShutdown = true;
+
         MOE_UV_CATCH_ALL_BEGIN
             self->OnShutdown();
         MOE_UV_CATCH_ALL_END
@@ -56,6 +450,16 @@ void Stream::OnUVWrite(::uv_write_s* request, int status)noexcept
     owner.reset(static_cast<UVWriteRequest*>(request->data));
 
     auto handle = request->handle;
+
+    // 屏障的回调是内部流程（如sendfile、转发）的后续步骤，对象已销毁时也必须执行，否则其上下文无法释放
+    if (owner->Barrier && owner->OnWrite && !GetSelf<Stream>(handle))
+    {
+        MOE_UV_CATCH_ALL_BEGIN
+            owner->OnWrite(static_cast<uv_errno_t>(UV_ECANCELED));
+        MOE_UV_CATCH_ALL_END
+        return;
+    }
+
     MOE_UV_GET_SELF(Stream);
 
     if (status != 0)  // 通知错误发生
@@ -79,6 +483,12 @@ void Stream::OnUVWrite(::uv_write_s* request, int status)noexcept
     }
     else
     {
+        if (self->m_pIoStats && !owner->Barrier)
+        {
+            ++self->m_pIoStats->WriteOps;
+            self->m_pIoStats->BytesWritten += owner->BufferDesc.len;
+        }
+
         // 通知数据发送
         if (owner->OnWrite)
         {
@@ -95,10 +505,10 @@ void Stream::OnUVAllocBuffer(::uv_handle_s* handle, size_t suggestedSize, ::uv_b
 
     MOE_UV_CATCH_ALL_BEGIN
         *buf = ::uv_buf_init(nullptr, 0);
-        MOE_UV_ALLOC(suggestedSize);
+        MOE_UV_ALLOC(AllocCategory::ReadBuffer, suggestedSize);
 
         // 所有权移交到uv_buf_t中
-        *buf = ::uv_buf_init(static_cast<char*>(buffer.release()), static_cast<unsigned>(suggestedSize));
+        *buf = ::uv_buf_init(static_cast<char*>(buffer.Release()), static_cast<unsigned>(suggestedSize));
     MOE_UV_CATCH_ALL_END
 }
 
@@ -107,8 +517,33 @@ void Stream::OnUVRead(::uv_stream_s* handle, ssize_t nread, const ::uv_buf_t* bu
     MOE_UV_GET_SELF(Stream);
 
     // 获取所有权，确保调用后对象释放
-    UniquePooledObject<void> buffer;
-    buffer.reset(buf->base);
+    PooledBuffer buffer;
+    buffer.Adopt(AllocCategory::ReadBuffer, buf->base, buf->len);
+
+    if (nread > 0 && self->m_pIoStats)
+    {
+        ++self->m_pIoStats->ReadOps;
+        self->m_pIoStats->BytesRead += static_cast<size_t>(nread);
+    }
+
+    // 转发模式
+    if (self->m_pRelay && nread != 0)
+    {
+        if (nread > 0)
+        {
+            RelayContext::Forward(self->m_pRelay, std::move(buffer), static_cast<size_t>(nread));
+            return;
+        }
+
+        RelayContext::Finish(self->m_pRelay, nread == UV_EOF ? 0 : static_cast<int>(nread));
+        if (nread == UV_EOF)
+            return;
+
+        // 错误依旧按常规流程处理
+        self = GetSelf<Stream>(handle);
+        if (!self)
+            return;
+    }
 
     if (nread < 0)  // 通知错误发生
     {
@@ -128,20 +563,66 @@ void Stream::OnUVRead(::uv_stream_s* handle, ssize_t nread, const ::uv_buf_t* bu
     {
         MOE_UV_CATCH_ALL_BEGIN
             // 通知数据读取
-            self->OnData(BytesView(static_cast<const uint8_t*>(buffer.get()), nread));
+            self->OnData(BytesView(static_cast<const uint8_t*>(buffer.Get()), nread));
         MOE_UV_CATCH_ALL_END
     }
 }
 
+Stream::Stream(UniquePooledObject<::uv_handle_s>&& handle)
+    : AsyncHandle(std::move(handle))
+{
+    auto loop = RunLoop::GetCurrent();
+    if (loop && loop->IsIoStatsEnabledByDefault())
+        SetIoStatsEnabled(true);
+}
+
 Stream::Stream(Stream&& org)noexcept
-    : AsyncHandle(std::move(org)), m_pOnError(std::move(org.m_pOnError)), m_pOnShutdown(std::move(org.m_pOnShutdown)),
+    : AsyncHandle(std::move(org)), m_bListening(org.m_bListening), m_bShuttingDown(org.m_bShuttingDown),
+    m_bShutdown(org.m_bShutdown), m_bWriteBlocked(org.m_bWriteBlocked),
+    m_stDeferredWrites(std::move(org.m_stDeferredWrites)), m_pDeferredShutdown(org.m_pDeferredShutdown),
+    m_pRelay(org.m_pRelay), m_pRelayFrom(org.m_pRelayFrom),
+    m_pIoStats(std::move(org.m_pIoStats)), m_pOnError(std::move(org.m_pOnError)), m_pOnShutdown(std::move(org.m_pOnShutdown)),
     m_pOnData(std::move(org.m_pOnData)), m_pOnEof(std::move(org.m_pOnEof))
 {
+    org.m_bListening = false;
+    org.m_bShuttingDown = false;
+    org.m_bShutdown = false;
+    org.m_bWriteBlocked = false;
+    org.m_stDeferredWrites.clear();
+    org.m_pDeferredShutdown = nullptr;
+    org.m_pRelay = nullptr;
+    org.m_pRelayFrom = nullptr;
+}
+
+Stream::~Stream()
+{
+    DetachRelay();
+    CancelDeferredWrites();
 }
 
 Stream& Stream::operator=(Stream&& rhs)noexcept
 {
+    DetachRelay();
+    CancelDeferredWrites();
+
     AsyncHandle::operator=(std::move(rhs));
+    m_bListening = rhs.m_bListening;
+    m_bShuttingDown = rhs.m_bShuttingDown;
+    m_bShutdown = rhs.m_bShutdown;
+    m_bWriteBlocked = rhs.m_bWriteBlocked;
+    m_stDeferredWrites = std::move(rhs.m_stDeferredWrites);
+    m_pDeferredShutdown = rhs.m_pDeferredShutdown;
+    m_pRelay = rhs.m_pRelay;
+    m_pRelayFrom = rhs.m_pRelayFrom;
+    rhs.m_bListening = false;
+    rhs.m_bShuttingDown = false;
+    rhs.m_bShutdown = false;
+    rhs.m_bWriteBlocked = false;
+    rhs.m_stDeferredWrites.clear();
+    rhs.m_pDeferredShutdown = nullptr;
+    rhs.m_pRelay = nullptr;
+    rhs.m_pRelayFrom = nullptr;
+    m_pIoStats = std::move(rhs.m_pIoStats);
     m_pOnError = std::move(rhs.m_pOnError);
     m_pOnShutdown = std::move(rhs.m_pOnShutdown);
     m_pOnData = std::move(rhs.m_pOnData);
@@ -170,17 +651,34 @@ size_t Stream::GetWriteQueueSize()const noexcept
     if (IsClosing())
         return 0;
     MOE_UV_GET_HANDLE_NOTHROW(::uv_stream_t);
-    return ::uv_stream_get_write_queue_size(handle);
+
+    // 被写屏障暂存的数据同样计入
+    auto size = ::uv_stream_get_write_queue_size(handle);
+    for (auto request : m_stDeferredWrites)
+        size += static_cast<UVWriteRequest*>(request->data)->BufferDesc.len;
+    return size;
 }
 
 void Stream::Shutdown()
 {
     MOE_UV_GET_HANDLE(::uv_stream_t);
+    if (m_pDeferredShutdown)
+        MOE_UV_THROW(UV_ENOTCONN);
 
     MOE_UV_NEW(UVShutdownRequest);
 
+    // 与写操作一样排在写屏障之后，由ReleaseWriteBarrier发起
+    if (m_bWriteBlocked)
+    {
+        m_pDeferredShutdown = &object->Request;
+        m_pDeferredShutdown->data = object.release();
+        m_bShuttingDown = true;
+        return;
+    }
+
     // 发起关闭操作
     MOE_UV_CHECK(::uv_shutdown(&object->Request, handle, OnUVShutdown));
+    m_bShuttingDown = true;
 
     // 释放所有权，交由UV管理
     auto& req = object->Request;
@@ -213,18 +711,18 @@ void Stream::Write(BytesView buf)
     MOE_UV_NEW(UVWriteRequest);
 
     // 分配缓冲区并拷贝数据
-    MOE_UV_ALLOC(buf.GetSize());
+    MOE_UV_ALLOC(AllocCategory::WriteCopy, buf.GetSize());
     object->CopiedBuffer = std::move(buffer);
-    object->BufferDesc = ::uv_buf_init(static_cast<char*>(object->CopiedBuffer.get()),
+    object->BufferDesc = ::uv_buf_init(static_cast<char*>(object->CopiedBuffer.Get()),
         static_cast<unsigned>(buf.GetSize()));
-    memcpy(object->CopiedBuffer.get(), buf.GetBuffer(), buf.GetSize());
-
-    // 发起写操作
-    MOE_UV_CHECK(::uv_write(&object->Request, handle, &(object->BufferDesc), 1, OnUVWrite));
+    memcpy(object->CopiedBuffer.Get(), buf.GetBuffer(), buf.GetSize());
 
     // 释放所有权，交由UV管理
     auto& req = object->Request;
     req.data = object.release();
+
+    // 发起写操作
+    SubmitWrite(handle, &req);
 }
 
 void Stream::WriteNoCopy(BytesView buffer, const OnWriteCallbackType& cb)
@@ -238,12 +736,12 @@ void Stream::WriteNoCopy(BytesView buffer, const OnWriteCallbackType& cb)
     object->BufferDesc = ::uv_buf_init(const_cast<char*>(reinterpret_cast<const char*>(buffer.GetBuffer())),
         static_cast<unsigned>(buffer.GetSize()));
 
-    // 发起写操作
-    MOE_UV_CHECK(::uv_write(&object->Request, handle, &(object->BufferDesc), 1, OnUVWrite));
-
     // 释放所有权，交由UV管理
     auto& req = object->Request;
     req.data = object.release();
+
+    // 发起写操作
+    SubmitWrite(handle, &req);
 }
 
 void Stream::WriteNoCopy(BytesView buffer, OnWriteCallbackType&& cb)
@@ -257,12 +755,12 @@ void Stream::WriteNoCopy(BytesView buffer, OnWriteCallbackType&& cb)
     object->BufferDesc = ::uv_buf_init(const_cast<char*>(reinterpret_cast<const char*>(buffer.GetBuffer())),
         static_cast<unsigned>(buffer.GetSize()));
 
-    // 发起写操作
-    MOE_UV_CHECK(::uv_write(&object->Request, handle, &(object->BufferDesc), 1, OnUVWrite));
-
     // 释放所有权，交由UV管理
     auto& req = object->Request;
     req.data = object.release();
+
+    // 发起写操作
+    SubmitWrite(handle, &req);
 }
 
 bool Stream::TryWrite(BytesView buffer)
@@ -271,20 +769,189 @@ bool Stream::TryWrite(BytesView buffer)
     if (buffer.GetSize() == 0)
         MOE_THROW(BadArgumentException, "Buffer is empty");
 
+    // 不能越过写屏障及暂存的写操作
+    if (m_bWriteBlocked || !m_stDeferredWrites.empty())
+        return false;
+
     ::uv_buf_t desc = ::uv_buf_init(const_cast<char*>(reinterpret_cast<const char*>(buffer.GetBuffer())),
         static_cast<unsigned>(buffer.GetSize()));
 
     // 发起写操作
     auto r = ::uv_try_write(handle, &desc, 1);
     if (r >= 0)
+    {
+        if (m_pIoStats)
+        {
+            ++m_pIoStats->WriteOps;
+            m_pIoStats->BytesWritten += static_cast<size_t>(r);
+        }
         return true;
+    }
     else if (r == UV_EAGAIN)
         return false;
     MOE_UV_THROW(r);
 }
 
+bool Stream::Close()noexcept
+{
+    if (!AsyncHandle::Close())
+        return false;
+
+    DetachRelay();
+    CancelDeferredWrites();
+    return true;
+}
+
+void Stream::SetIoStatsEnabled(bool enabled)
+{
+    if (!enabled)
+    {
+        m_pIoStats.reset();
+        return;
+    }
+    if (m_pIoStats)
+        return;
+
+    m_pIoStats.reset(new IoStats());
+    m_pIoStats->StartTime = RunLoop::Now();
+}
+
+void Stream::RelayTo(Stream& target, const OnRelayEndCallbackType& cb)
+{
+    RelayTo(target, OnRelayEndCallbackType(cb));
+}
+
+void Stream::RelayTo(Stream& target, OnRelayEndCallbackType&& cb)
+{
+    MOE_UV_GET_HANDLE(::uv_stream_t);
+    if (&target == this)
+        MOE_THROW(BadArgumentException, "Cannot relay to self");
+    if (target.IsClosing())
+        MOE_THROW(InvalidCallException, "Target is already disposed");
+    if (m_pRelay)
+        MOE_THROW(InvalidCallException, "Stream is already relaying");
+    if (target.m_pRelayFrom)
+        MOE_THROW(InvalidCallException, "Target is already relayed from another stream");
+
+    auto targetHandle = reinterpret_cast<::uv_stream_t*>(target.GetHandle());
+
+    MOE_UV_NEW(RelayContext);
+    object->Loop = handle->loop;
+    object->Source = handle;
+    object->Target = targetHandle;
+    object->OnEnd = std::move(cb);
+
+#ifdef MOE_LINUX
+    auto spliceable = [](::uv_stream_t* h) { return h->type == UV_TCP || h->type == UV_NAMED_PIPE; };
+    object->Splice = spliceable(handle) && spliceable(targetHandle);
+#endif
+
+    if (object->Splice)
+    {
+#ifdef MOE_LINUX
+        // 等待目标上已有的写操作完成后再开始搬运
+        ::uv_read_stop(handle);
+
+        auto context = object.get();
+        ++context->Pending;
+        target.WriteBarrier([context, targetHandle](int status) {
+            RelayContext::OnBarrier(context, targetHandle, status);
+        });
+#endif
+    }
+    else
+    {
+        auto r = ::uv_read_start(handle, OnUVAllocBuffer, OnUVRead);
+        if (r != UV_EALREADY)
+            MOE_UV_CHECK(r);
+    }
+
+    m_pRelay = object.get();
+    target.m_pRelayFrom = object.release();
+}
+
+void Stream::StopRelay()noexcept
+{
+    if (m_pRelay)
+        RelayContext::Finish(m_pRelay, UV_ECANCELED);
+}
+
+void Stream::WriteBarrier(OnWriteCallbackType&& cb)
+{
+    MOE_UV_GET_HANDLE(::uv_stream_t);
+
+    // 使用一个长度为0的写请求标记屏障位置，其回调时之前的写请求均已完成
+    MOE_UV_NEW(UVWriteRequest);
+    object->Barrier = true;
+    object->OnWrite = std::move(cb);
+    object->BufferDesc = ::uv_buf_init(nullptr, 0);
+
+    auto& req = object->Request;
+    req.data = object.release();
+
+    SubmitWrite(handle, &req);
+}
+
+void Stream::ReleaseWriteBarrier()noexcept
+{
+    m_bWriteBlocked = false;
+
+    if (IsClosing())
+    {
+        CancelDeferredWrites();
+        return;
+    }
+
+    MOE_UV_GET_HANDLE_NOTHROW(::uv_stream_t);
+    while (!m_bWriteBlocked && !m_stDeferredWrites.empty())
+    {
+        auto request = m_stDeferredWrites.front();
+        m_stDeferredWrites.pop_front();
+
+        auto owner = static_cast<UVWriteRequest*>(request->data);
+        auto r = ::uv_write(request, handle, &(owner->BufferDesc), 1, OnUVWrite);
+        if (r < 0)
+        {
+            UniquePooledObject<UVWriteRequest> p;
+            p.reset(owner);
+
+            if (p->OnWrite)
+            {
+                MOE_UV_CATCH_ALL_BEGIN
+                    p->OnWrite(static_cast<uv_errno_t>(r));
+                MOE_UV_CATCH_ALL_END
+            }
+            continue;
+        }
+
+        if (owner->Barrier)
+            m_bWriteBlocked = true;
+    }
+    UpdateWriteQueueHighWater(handle);
+
+    if (!m_bWriteBlocked && m_pDeferredShutdown)
+    {
+        auto request = m_pDeferredShutdown;
+        m_pDeferredShutdown = nullptr;
+
+        auto r = ::uv_shutdown(request, handle, OnUVShutdown);
+        if (r < 0)
+        {
+            UniquePooledObject<UVShutdownRequest> p;
+            p.reset(static_cast<UVShutdownRequest*>(request->data));
+
+            MOE_UV_CATCH_ALL_BEGIN
+                OnError(static_cast<uv_errno_t>(r));
+            MOE_UV_CATCH_ALL_END
+            Close();
+        }
+    }
+}
+
 void Stream::OnError(int error)
 {
+    if (m_pIoStats)
+        ++m_pIoStats->Errors;
     if (m_pOnError)
         m_pOnError(error);
 }
@@ -306,3 +973,82 @@ void Stream::OnEof()
     if (m_pOnEof)
         m_pOnEof();
 }
+
+void Stream::SubmitWrite(::uv_stream_s* handle, ::uv_write_s* request)
+{
+    UniquePooledObject<UVWriteRequest> owner;
+    owner.reset(static_cast<UVWriteRequest*>(request->data));
+
+    // Shutdown排队期间写端已视为关闭，与libuv的行为保持一致
+    if (m_pDeferredShutdown)
+        MOE_UV_THROW(UV_EPIPE);
+
+    if (m_bWriteBlocked)
+    {
+        m_stDeferredWrites.push_back(request);
+        owner.release();
+        return;
+    }
+
+    MOE_UV_CHECK(::uv_write(request, handle, &(owner->BufferDesc), 1, OnUVWrite));
+
+    if (owner->Barrier)
+        m_bWriteBlocked = true;
+    owner.release();
+    UpdateWriteQueueHighWater(handle);
+}
+
+void Stream::CancelDeferredWrites()noexcept
+{
+    m_bWriteBlocked = false;
+    if (m_pDeferredShutdown)
+    {
+        UniquePooledObject<UVShutdownRequest> p;
+        p.reset(static_cast<UVShutdownRequest*>(m_pDeferredShutdown->data));
+        m_pDeferredShutdown = nullptr;
+    }
+    if (m_stDeferredWrites.empty())
+        return;
+
+    // 回调中可能再次操作队列，先取出
+    auto requests = std::move(m_stDeferredWrites);
+    m_stDeferredWrites.clear();
+
+    for (auto request : requests)
+    {
+        UniquePooledObject<UVWriteRequest> owner;
+        owner.reset(static_cast<UVWriteRequest*>(request->data));
+
+        if (owner->OnWrite)
+        {
+            MOE_UV_CATCH_ALL_BEGIN
+                owner->OnWrite(static_cast<uv_errno_t>(UV_ECANCELED));
+            MOE_UV_CATCH_ALL_END
+        }
+    }
+}
+
+void Stream::DetachRelay()noexcept
+{
+    if (m_pRelay)
+        RelayContext::Finish(m_pRelay, UV_ECANCELED);
+    if (m_pRelayFrom)
+    {
+        RelayContext::Finish(m_pRelayFrom, UV_ECANCELED);
+
+        // 转发等待的屏障若仍暂存在队列中则不会再被提交，立即取消以释放其对上下文的引用
+        // 已提交的屏障在句柄关闭时由libuv以UV_ECANCELED回调，见OnUVWrite
+        CancelDeferredWrites();
+    }
+    assert(!m_pRelay && !m_pRelayFrom);
+}
+
+void Stream::UpdateWriteQueueHighWater(::uv_stream_s* handle)noexcept
+{
+    if (!m_pIoStats)
+        return;
+
+    auto size = ::uv_stream_get_write_queue_size(handle);
+    if (size > m_pIoStats->WriteQueueHighWater)
+        m_pIoStats->WriteQueueHighWater = size;
+}
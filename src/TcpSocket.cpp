@@ -7,6 +7,11 @@
 
 #include "UV.inl"
 
+#ifndef MOE_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 using namespace moe;
 using namespace UV;
@@ -18,9 +23,17 @@ TcpSocket TcpSocket::Create()
     return TcpSocket(CastHandle(std::move(object)));
 }
 
+TcpSocket TcpSocket::Create(int fd)
+{
+    auto ret = Create();
+    ret.Open(fd);
+    return ret;
+}
+
 struct UVConnectRequest
 {
     ::uv_connect_t Request;
+    AllocAccount Account { AllocCategory::Request, sizeof(UVConnectRequest) };
 };
 
 void TcpSocket::OnUVConnect(::uv_connect_s* request, int status)noexcept
@@ -57,14 +70,280 @@ void TcpSocket::OnUVConnection(::uv_stream_s* handle, int status)noexcept
     }
 }
 
+//////////////////////////////////////////////////////////////////////////////// TcpSocket::SendFileContext
+
+struct TcpSocket::SendFileContext :
+    public InternalHandleOwner
+{
+    // sendfile单次最大长度（与Linux的MAX_RW_COUNT一致）
+    static const size_t kMaxChunkSize = 0x7FFFF000u;
+
+    ::uv_fs_t Request;
+    ::uv_poll_t Poll;
+    AllocAccount Account { AllocCategory::Request, sizeof(TcpSocket::SendFileContext) };
+    bool PollInited = false;  // 关闭回调后复位
+    bool PollClosed = false;
+    bool Sending = false;  // sendfile请求尚未回调
+    bool Finished = false;
+
+    ::uv_loop_t* Loop = nullptr;
+    ::uv_tcp_t* Handle = nullptr;  // 套接字对象销毁后置空
+    int SocketFd = -1;  // 复制的套接字句柄，保证发送过程中句柄不被复用
+    int FileFd = -1;
+    int64_t Offset = 0;
+    size_t Remaining = 0;
+    OnWriteCallbackType OnComplete;
+
+    SendFileContext()noexcept
+        : InternalHandleOwner(OnUVPollClose)
+    {
+        ::memset(&Request, 0, sizeof(Request));
+        ::memset(&Poll, 0, sizeof(Poll));
+    }
+
+    ~SendFileContext()
+    {
+        ::uv_fs_req_cleanup(&Request);
+#ifndef MOE_WINDOWS
+        if (SocketFd >= 0)
+            ::close(SocketFd);
+#endif
+    }
+
+    TcpSocket* GetSelf()noexcept
+    {
+        if (!Handle)
+            return nullptr;
+        auto self = ::GetSelf<TcpSocket>(Handle);
+        if (!self || self->IsClosing())
+            return nullptr;
+        return self;
+    }
+
+    static void OnReady(SendFileContext* context, int status)noexcept;
+    static void OnUVSendFile(::uv_fs_t* request)noexcept;
+    static void OnUVWritable(::uv_poll_t* handle, int status, int events)noexcept;
+    static void OnUVPollClose(::uv_handle_t* handle)noexcept;
+
+    static void Send(SendFileContext* context)noexcept;
+    static void WaitWritable(SendFileContext* context)noexcept;
+    static void Finish(SendFileContext* context, int status)noexcept;
+};
+
+const size_t TcpSocket::SendFileContext::kMaxChunkSize;
+
+void TcpSocket::SendFileContext::OnReady(SendFileContext* context, int status)noexcept
+{
+    if (status != 0)
+    {
+        Finish(context, status);
+        return;
+    }
+
+    auto self = context->GetSelf();
+    if (!self)
+    {
+        Finish(context, UV_ECANCELED);
+        return;
+    }
+
+    assert(self->m_pSendFile == nullptr);
+    self->m_pSendFile = context;
+
+#ifdef MOE_WINDOWS
+    Finish(context, UV_ENOTSUP);
+#else
+    ::uv_os_fd_t fd;
+    auto r = ::uv_fileno(reinterpret_cast<::uv_handle_t*>(context->Handle), &fd);
+    if (r < 0)
+    {
+        Finish(context, r);
+        return;
+    }
+
+    context->SocketFd = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (context->SocketFd < 0)
+    {
+        Finish(context, -errno);
+        return;
+    }
+
+    Send(context);
+#endif
+}
+
+void TcpSocket::SendFileContext::OnUVSendFile(::uv_fs_t* request)noexcept
+{
+    auto context = static_cast<SendFileContext*>(request->data);
+    auto result = request->result;
+    ::uv_fs_req_cleanup(request);
+    context->Sending = false;
+
+    if (result == UV_EAGAIN)
+    {
+        WaitWritable(context);
+        return;
+    }
+    else if (result < 0)
+    {
+        Finish(context, static_cast<int>(result));
+        return;
+    }
+    else if (result == 0)
+    {
+        Finish(context, UV_EOF);  // 文件长度不足
+        return;
+    }
+
+    assert(static_cast<size_t>(result) <= context->Remaining);
+    context->Offset += result;
+    context->Remaining -= static_cast<size_t>(result);
+
+    if (context->Remaining == 0)
+        Finish(context, 0);
+    else
+        WaitWritable(context);  // 只发送了部分数据，说明套接字缓冲区已满
+}
+
+void TcpSocket::SendFileContext::OnUVWritable(::uv_poll_t* handle, int status, int events)noexcept
+{
+    MOE_UNUSED(status);
+    MOE_UNUSED(events);
+    auto context = static_cast<SendFileContext*>(FromData(handle->data));
+
+    ::uv_poll_stop(handle);
+
+    // 出错时（如POLLERR）libuv只给出UV_EBADF，交由sendfile返回实际的错误
+    Send(context);
+}
+
+void TcpSocket::SendFileContext::OnUVPollClose(::uv_handle_t* handle)noexcept
+{
+    auto context = static_cast<SendFileContext*>(FromData(handle->data));
+    context->PollInited = false;
+    context->PollClosed = true;
+
+    if (context->Finished)
+    {
+        UniquePooledObject<SendFileContext> p;
+        p.reset(context);
+        return;
+    }
+
+    // 被RunLoop强制关闭，没有正在进行的sendfile时不会再有回调驱动，直接结束
+    if (!context->Sending)
+        Finish(context, UV_ECANCELED);
+}
+
+void TcpSocket::SendFileContext::Send(SendFileContext* context)noexcept
+{
+    if (!context->GetSelf())
+    {
+        Finish(context, UV_ECANCELED);
+        return;
+    }
+
+    auto length = std::min(context->Remaining, kMaxChunkSize);
+    context->Request.data = context;
+    auto r = ::uv_fs_sendfile(context->Loop, &context->Request, context->SocketFd, context->FileFd, context->Offset,
+        length, OnUVSendFile);
+    if (r < 0)
+        Finish(context, r);
+    else
+        context->Sending = true;
+}
+
+void TcpSocket::SendFileContext::WaitWritable(SendFileContext* context)noexcept
+{
+    if (!context->GetSelf())
+    {
+        Finish(context, UV_ECANCELED);
+        return;
+    }
+
+    // 轮询句柄已被RunLoop强制关闭
+    auto poll = reinterpret_cast<::uv_handle_t*>(&context->Poll);
+    if (context->PollClosed || (context->PollInited && ::uv_is_closing(poll)))
+    {
+        Finish(context, UV_ECANCELED);
+        return;
+    }
+
+    // 在复制的句柄上监听可写事件，不干扰libuv对原句柄的轮询
+    if (!context->PollInited)
+    {
+        auto r = ::uv_poll_init(context->Loop, &context->Poll, context->SocketFd);
+        if (r < 0)
+        {
+            Finish(context, r);
+            return;
+        }
+        context->Poll.data = ToData(context);
+        context->PollInited = true;
+    }
+
+    auto r = ::uv_poll_start(&context->Poll, UV_WRITABLE, OnUVWritable);
+    if (r < 0)
+        Finish(context, r);
+}
+
+void TcpSocket::SendFileContext::Finish(SendFileContext* context, int status)noexcept
+{
+    assert(!context->Finished);
+    context->Finished = true;
+
+    if (context->Handle)
+    {
+        auto self = ::GetSelf<TcpSocket>(context->Handle);
+        if (self && self->m_pSendFile == context)
+        {
+            self->m_pSendFile = nullptr;
+            self->ReleaseWriteBarrier();
+        }
+    }
+
+    if (context->OnComplete)
+    {
+        MOE_UV_CATCH_ALL_BEGIN
+            context->OnComplete(static_cast<uv_errno_t>(status));
+        MOE_UV_CATCH_ALL_END
+    }
+
+    // 轮询句柄需要异步关闭，之后才能释放，被RunLoop强制关闭时已在关闭中
+    if (context->PollInited)
+    {
+        auto poll = reinterpret_cast<::uv_handle_t*>(&context->Poll);
+        if (!::uv_is_closing(poll))
+            ::uv_close(poll, OnUVPollClose);
+    }
+    else
+    {
+        UniquePooledObject<SendFileContext> p;
+        p.reset(context);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////// TcpSocket
+
 TcpSocket::TcpSocket(TcpSocket&& org)noexcept
-    : Stream(std::move(org)), m_pOnConnect(std::move(org.m_pOnConnect)), m_pOnConnection(std::move(org.m_pOnConnection))
+    : Stream(std::move(org)), m_pSendFile(org.m_pSendFile), m_pOnConnect(std::move(org.m_pOnConnect)),
+    m_pOnConnection(std::move(org.m_pOnConnection))
+{
+    org.m_pSendFile = nullptr;
+}
+
+TcpSocket::~TcpSocket()
 {
+    DetachSendFile();
 }
 
 TcpSocket& TcpSocket::operator=(TcpSocket&& rhs)noexcept
 {
+    DetachSendFile();
+
     Stream::operator=(std::move(rhs));
+    m_pSendFile = rhs.m_pSendFile;
+    rhs.m_pSendFile = nullptr;
     m_pOnConnect = std::move(rhs.m_pOnConnect);
     m_pOnConnection = std::move(rhs.m_pOnConnection);
     return *this;
@@ -94,6 +373,12 @@ void TcpSocket::SetSimultaneousAccepts(bool enable)
     MOE_UV_CHECK(::uv_tcp_simultaneous_accepts(handle, enable ? 1 : 0));
 }
 
+void TcpSocket::SetBusyPoll(unsigned usec)
+{
+    MOE_UV_GET_HANDLE(::uv_handle_t);
+    SetSocketBusyPoll(handle, usec);
+}
+
 void TcpSocket::Bind(const EndPoint& addr, bool ipv6Only)
 {
     MOE_UV_GET_HANDLE(::uv_tcp_t);
@@ -119,6 +404,7 @@ void TcpSocket::Listen(unsigned backlog)
 {
     MOE_UV_GET_HANDLE(::uv_stream_t);
     MOE_UV_CHECK(::uv_listen(handle, backlog, OnUVConnection));
+    SetListening();
 }
 
 TcpSocket TcpSocket::Accept()
@@ -131,6 +417,64 @@ TcpSocket TcpSocket::Accept()
     return TcpSocket(CastHandle(std::move(object)));
 }
 
+int TcpSocket::Detach()
+{
+    MOE_UV_GET_HANDLE(::uv_tcp_t);
+
+    if (::uv_stream_get_write_queue_size(reinterpret_cast<::uv_stream_t*>(handle)) != 0 || IsWriteBlocked())
+        MOE_THROW(InvalidCallException, "Write queue is not empty");
+
+#ifdef MOE_WINDOWS
+    MOE_THROW(InvalidCallException, "Not supported");
+#else
+    ::uv_os_fd_t fd;
+    MOE_UV_CHECK(::uv_fileno(GetHandle(), &fd));
+
+    // 复制句柄，使得关闭libuv句柄后连接依旧有效
+    int ret = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (ret < 0)
+        MOE_THROW(ApiException, "fcntl error {0}", errno);
+
+    StopRead();
+    Close();
+    return ret;
+#endif
+}
+
+void TcpSocket::SendFile(int fd, uint64_t offset, size_t length, const OnWriteCallbackType& cb)
+{
+    SendFile(fd, offset, length, OnWriteCallbackType(cb));
+}
+
+void TcpSocket::SendFile(int fd, uint64_t offset, size_t length, OnWriteCallbackType&& cb)
+{
+    MOE_UV_GET_HANDLE(::uv_tcp_t);
+    if (fd < 0)
+        MOE_THROW(BadArgumentException, "Invalid file descriptor");
+    if (length == 0)
+        MOE_THROW(BadArgumentException, "Length is zero");
+
+#ifdef MOE_WINDOWS
+    MOE_UNUSED(handle);
+    MOE_UNUSED(offset);
+    MOE_UNUSED(cb);
+    MOE_THROW(InvalidCallException, "Not supported");
+#else
+    MOE_UV_NEW(SendFileContext);
+    object->Loop = handle->loop;
+    object->Handle = handle;
+    object->FileFd = fd;
+    object->Offset = static_cast<int64_t>(offset);
+    object->Remaining = length;
+    object->OnComplete = std::move(cb);
+
+    // 屏障回调时之前的写操作均已完成，此后的写操作会暂存到文件发送完毕
+    auto context = object.get();
+    WriteBarrier([context](int status) { SendFileContext::OnReady(context, status); });
+    object.release();
+#endif
+}
+
 EndPoint TcpSocket::GetSockName()
 {
     MOE_UV_GET_HANDLE(::uv_tcp_t);
@@ -162,3 +506,13 @@ void TcpSocket::OnConnection()
     if (m_pOnConnection)
         m_pOnConnection();
 }
+
+void TcpSocket::DetachSendFile()noexcept
+{
+    // 对象即将失去句柄，通知发送过程在下一步时终止
+    if (m_pSendFile)
+    {
+        m_pSendFile->Handle = nullptr;
+        m_pSendFile = nullptr;
+    }
+}
@@ -14,6 +14,7 @@ using namespace UV;
 struct UVWorkReq
 {
     ::uv_work_t Request;
+    AllocAccount Account { AllocCategory::Work, sizeof(UVWorkReq) };
 
     ThreadPool::OnWorkCallbackType OnWork;
     ThreadPool::OnAfterWorkCallbackType OnAfterWork;
@@ -42,22 +43,17 @@ struct UVWorkReq
     }
 };
 
-#define MOVE_OWNER_SELF \
-    do { \
-        auto raw = object.release(); \
-        raw->Request.data = raw; \
-    } while (false)
-
 void ThreadPool::QueueWork(const OnWorkCallbackType& work, const OnAfterWorkCallbackType& afterWork, void* userData)
 {
     MOE_UV_NEW(UVWorkReq);
     object->OnWork = work;
     object->OnAfterWork = afterWork;
     object->UserData = userData;
+    object->Request.data = object.get();  // 工作线程可能在uv_queue_work返回前就开始执行
 
     MOE_UV_CHECK(::uv_queue_work(GetCurrentUVLoop(), &object->Request, UVWorkReq::WorkCallback,
         UVWorkReq::AfterWorkCallback));
-    MOVE_OWNER_SELF;
+    object.release();
 }
 
 void ThreadPool::QueueWork(OnWorkCallbackType&& work, OnAfterWorkCallbackType&& afterWork, void* userData)
@@ -66,8 +62,9 @@ void ThreadPool::QueueWork(OnWorkCallbackType&& work, OnAfterWorkCallbackType&&
     object->OnWork = std::move(work);
     object->OnAfterWork = std::move(afterWork);
     object->UserData = userData;
+    object->Request.data = object.get();  // 工作线程可能在uv_queue_work返回前就开始执行
 
     MOE_UV_CHECK(::uv_queue_work(GetCurrentUVLoop(), &object->Request, UVWorkReq::WorkCallback,
         UVWorkReq::AfterWorkCallback));
-    MOVE_OWNER_SELF;
+    object.release();
 }
@@ -0,0 +1,274 @@
+/**
+ * @file
+ * @author chu
+ * @date 2026/10/18
+ */
+#include <Moe.UV/Tracing.hpp>
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "UV.inl"
+
+using namespace std;
+using namespace moe;
+using namespace UV;
+
+namespace
+{
+    /**
+     * @brief 单个事件槽位
+     *
+     * 读取方与写入方并发访问，所有字段均为原子变量，通过Seq检测读取期间是否被覆盖。
+     */
+    struct TraceSlot
+    {
+        atomic<uint64_t> Seq;  // 写入完成后为事件序号+1，写入中为0
+        atomic<const char*> Site;
+        atomic<const void*> Handle;
+        atomic<uint64_t> Start;
+        atomic<uint64_t> Duration;
+    };
+
+    struct ThreadBuffer
+    {
+        uint32_t ThreadId = 0;
+        bool HasRunLoop = false;
+        size_t Mask = 0;
+        unique_ptr<TraceSlot[]> Slots;
+        atomic<uint64_t> Head;  // 仅由所属线程写入
+        atomic<uint64_t> ClearedBefore;
+
+        ThreadBuffer()
+            : Head(0), ClearedBefore(0) {}
+    };
+
+    struct TraceEvent
+    {
+        const char* Site;
+        const void* Handle;
+        uint64_t Start;
+        uint64_t Duration;
+    };
+
+    mutex g_stRegistryMutex;
+    vector<shared_ptr<ThreadBuffer>> g_stBuffers;
+    size_t g_uBufferSize = Tracing::kDefaultBufferSize;
+    uint32_t g_uNextThreadId = 1;
+
+    thread_local shared_ptr<ThreadBuffer> t_pBuffer;
+    thread_local const void* t_pCurrentHandle = nullptr;
+
+    ThreadBuffer* AcquireBuffer()
+    {
+        auto buffer = make_shared<ThreadBuffer>();
+        buffer->HasRunLoop = RunLoop::GetCurrent() != nullptr;
+
+        lock_guard<mutex> lock(g_stRegistryMutex);
+
+        // 容量取2的幂以便用掩码取槽位
+        size_t capacity = 1;
+        while (capacity < g_uBufferSize)
+            capacity <<= 1;
+        buffer->Slots.reset(new TraceSlot[capacity]);
+        for (size_t i = 0; i < capacity; ++i)
+            buffer->Slots[i].Seq.store(0, memory_order_relaxed);
+        buffer->Mask = capacity - 1;
+        buffer->ThreadId = g_uNextThreadId++;
+
+        g_stBuffers.push_back(buffer);
+        t_pBuffer = std::move(buffer);
+        return t_pBuffer.get();
+    }
+
+    /**
+     * @brief 从函数签名中提取类型和函数名
+     *
+     * 例如"static void moe::UV::Timer::OnUVTimer(uv_timer_t*)"提取为"Timer::OnUVTimer"。
+     */
+    string ShortenSite(const char* site)
+    {
+        string ret(site);
+        auto pos = ret.find('(');
+        if (pos != string::npos)
+            ret.erase(pos);
+        pos = ret.rfind(' ');
+        if (pos != string::npos)
+            ret.erase(0, pos + 1);
+
+        static const char kPrefix[] = "moe::UV::";
+        if (ret.compare(0, sizeof(kPrefix) - 1, kPrefix) == 0)
+            ret.erase(0, sizeof(kPrefix) - 1);
+        return ret;
+    }
+
+    void AppendJsonString(string& out, const string& value)
+    {
+        out.push_back('"');
+        for (auto ch : value)
+        {
+            if (ch == '"' || ch == '\\')
+                out.push_back('\\');
+            if (static_cast<unsigned char>(ch) < 0x20)
+                continue;
+            out.push_back(ch);
+        }
+        out.push_back('"');
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////// Tracing::HandleScope
+
+Tracing::HandleScope::HandleScope(const void* handle)noexcept
+{
+    if (!Tracing::IsEnabled())
+        return;
+
+    m_bActive = true;
+    m_pPrev = t_pCurrentHandle;
+    t_pCurrentHandle = handle;
+}
+
+Tracing::HandleScope::~HandleScope()
+{
+    if (m_bActive)
+        t_pCurrentHandle = m_pPrev;
+}
+
+//////////////////////////////////////////////////////////////////////////////// Tracing
+
+const size_t Tracing::kDefaultBufferSize;
+
+std::atomic<bool> Tracing::s_bEnabled(false);
+
+void Tracing::Start(size_t bufferSize)
+{
+    if (bufferSize == 0)
+        MOE_THROW(BadArgumentException, "Buffer size must be positive");
+
+    {
+        lock_guard<mutex> lock(g_stRegistryMutex);
+        g_uBufferSize = bufferSize;
+    }
+    s_bEnabled.store(true, memory_order_relaxed);
+}
+
+void Tracing::Stop()noexcept
+{
+    s_bEnabled.store(false, memory_order_relaxed);
+}
+
+void Tracing::Clear()noexcept
+{
+    lock_guard<mutex> lock(g_stRegistryMutex);
+    for (const auto& buffer : g_stBuffers)
+        buffer->ClearedBefore.store(buffer->Head.load(memory_order_acquire), memory_order_relaxed);
+}
+
+void Tracing::DumpChromeTrace(std::string& out)
+{
+    vector<shared_ptr<ThreadBuffer>> buffers;
+    {
+        lock_guard<mutex> lock(g_stRegistryMutex);
+        buffers = g_stBuffers;
+    }
+
+    auto pid = static_cast<int>(::uv_os_getpid());
+    unordered_map<const char*, string> names;
+    vector<TraceEvent> events;
+    char tmp[128];
+
+    out.clear();
+    out.append("{\"traceEvents\":[");
+    bool first = true;
+
+    for (const auto& buffer : buffers)
+    {
+        ::snprintf(tmp, sizeof(tmp), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,"
+            "\"args\":{\"name\":\"%s %u\"}}", first ? "" : ",", pid, buffer->ThreadId,
+            buffer->HasRunLoop ? "RunLoop" : "Thread", buffer->ThreadId);
+        out.append(tmp);
+        first = false;
+
+        // 先整体拷贝出来，再逐个校验是否在拷贝期间被覆盖
+        auto capacity = buffer->Mask + 1;
+        auto head = buffer->Head.load(memory_order_acquire);
+        auto begin = head > capacity ? head - capacity : 0;
+        begin = std::max<uint64_t>(begin, buffer->ClearedBefore.load(memory_order_relaxed));
+
+        events.clear();
+        for (auto i = begin; i < head; ++i)
+        {
+            auto& slot = buffer->Slots[i & buffer->Mask];
+            auto seq = slot.Seq.load(memory_order_acquire);
+            if (seq != i + 1)
+                continue;
+
+            TraceEvent event;
+            event.Site = slot.Site.load(memory_order_relaxed);
+            event.Handle = slot.Handle.load(memory_order_relaxed);
+            event.Start = slot.Start.load(memory_order_relaxed);
+            event.Duration = slot.Duration.load(memory_order_relaxed);
+
+            atomic_thread_fence(memory_order_acquire);
+            if (slot.Seq.load(memory_order_relaxed) != seq)
+                continue;
+            events.push_back(event);
+        }
+
+        for (const auto& event : events)
+        {
+            auto it = names.find(event.Site);
+            if (it == names.end())
+                it = names.emplace(event.Site, ShortenSite(event.Site)).first;
+
+            out.append(",{\"name\":");
+            AppendJsonString(out, it->second);
+            ::snprintf(tmp, sizeof(tmp), ",\"cat\":\"uv\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                pid, buffer->ThreadId, event.Start / 1000., event.Duration / 1000.);
+            out.append(tmp);
+            if (event.Handle)
+            {
+                ::snprintf(tmp, sizeof(tmp), ",\"args\":{\"handle\":\"%p\"}", event.Handle);
+                out.append(tmp);
+            }
+            out.push_back('}');
+        }
+    }
+
+    out.append("],\"displayTimeUnit\":\"ns\"}");
+}
+
+void Tracing::Record(const char* site, uint64_t start, uint64_t duration)noexcept
+{
+    auto buffer = t_pBuffer.get();
+    if (!buffer)
+    {
+        try
+        {
+            buffer = AcquireBuffer();
+        }
+        catch (...)
+        {
+            return;
+        }
+    }
+
+    auto index = buffer->Head.load(memory_order_relaxed);
+    auto& slot = buffer->Slots[index & buffer->Mask];
+
+    // 先使槽位失效，读取方据此丢弃写入中的事件
+    slot.Seq.store(0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    slot.Site.store(site, memory_order_relaxed);
+    slot.Handle.store(t_pCurrentHandle, memory_order_relaxed);
+    slot.Start.store(start, memory_order_relaxed);
+    slot.Duration.store(duration, memory_order_relaxed);
+
+    slot.Seq.store(index + 1, memory_order_release);
+    buffer->Head.store(index + 1, memory_order_release);
+}
@@ -1,4 +1,6 @@
 #include <Moe.UV/RunLoop.hpp>
+#include <Moe.UV/AsyncLogAppender.hpp>
+#include <Moe.UV/Tracing.hpp>
 #include <Moe.Core/Logging.hpp>
 
 #include <uv.h>
@@ -35,6 +37,118 @@ namespace
         return static_cast<T*>(base);
     }
 
+    /**
+     * @brief 分配记账
+     *
+     * 嵌入在由MOE_UV_NEW创建的请求结构体中，构造时计入当前RunLoop的对应分类，随结构体析构时扣除。
+     * 对象池的释放不经过Moe.UV，因此由对象自身负责记账。
+     */
+    class AllocAccount :
+        public moe::NonCopyable
+    {
+    public:
+        AllocAccount(moe::UV::AllocCategory category, size_t size)noexcept
+            : m_iCategory(category), m_uSize(static_cast<uint32_t>(size))
+        {
+            auto loop = moe::UV::RunLoop::GetCurrent();
+            if (loop)
+                loop->RecordAlloc(m_iCategory, m_uSize);
+        }
+
+        ~AllocAccount()
+        {
+            auto loop = moe::UV::RunLoop::GetCurrent();
+            if (loop)
+                loop->RecordFree(m_iCategory, m_uSize);
+        }
+
+    private:
+        moe::UV::AllocCategory m_iCategory;
+        uint32_t m_uSize;
+    };
+
+    /**
+     * @brief 带记账的缓冲区
+     *
+     * - 由MOE_UV_ALLOC创建，析构时释放内存并扣除对应分类的计数。
+     * - Release后内存和计数一同交由调用方（如uv_buf_t）持有，之后通过Adopt重新接管。
+     */
+    class PooledBuffer :
+        public moe::NonCopyable
+    {
+    public:
+        PooledBuffer() = default;
+
+        PooledBuffer(moe::UV::AllocCategory category, moe::UniquePooledObject<void>&& buffer, size_t size)noexcept
+            : m_pBuffer(std::move(buffer)), m_uSize(size), m_iCategory(category)
+        {
+            auto loop = moe::UV::RunLoop::GetCurrent();
+            if (loop && m_pBuffer)
+                loop->RecordAlloc(m_iCategory, m_uSize);
+        }
+
+        PooledBuffer(PooledBuffer&& rhs)noexcept
+            : m_pBuffer(std::move(rhs.m_pBuffer)), m_uSize(rhs.m_uSize), m_iCategory(rhs.m_iCategory)
+        {
+            rhs.m_uSize = 0;
+        }
+
+        ~PooledBuffer()
+        {
+            Reset();
+        }
+
+        PooledBuffer& operator=(PooledBuffer&& rhs)noexcept
+        {
+            if (this != &rhs)
+            {
+                Reset();
+                m_pBuffer = std::move(rhs.m_pBuffer);
+                m_uSize = rhs.m_uSize;
+                m_iCategory = rhs.m_iCategory;
+                rhs.m_uSize = 0;
+            }
+            return *this;
+        }
+
+        explicit operator bool()const noexcept { return m_pBuffer != nullptr; }
+
+    public:
+        void* Get()const noexcept { return m_pBuffer.get(); }
+        size_t GetSize()const noexcept { return m_uSize; }
+
+        void* Release()noexcept
+        {
+            m_uSize = 0;
+            return m_pBuffer.release();
+        }
+
+        void Adopt(moe::UV::AllocCategory category, void* buffer, size_t size)noexcept
+        {
+            Reset();
+            m_pBuffer.reset(buffer);
+            m_uSize = buffer ? size : 0;
+            m_iCategory = category;
+        }
+
+        void Reset()noexcept
+        {
+            if (!m_pBuffer)
+                return;
+
+            auto loop = moe::UV::RunLoop::GetCurrent();
+            if (loop)
+                loop->RecordFree(m_iCategory, m_uSize);
+            m_pBuffer.reset();
+            m_uSize = 0;
+        }
+
+    private:
+        moe::UniquePooledObject<void> m_pBuffer;
+        size_t m_uSize = 0;
+        moe::UV::AllocCategory m_iCategory = moe::UV::AllocCategory::ReadBuffer;
+    };
+
     template <typename T>
     moe::UniquePooledObject<::uv_handle_t> CastHandle(moe::UniquePooledObject<T>&& rhs)noexcept
     {
@@ -42,6 +156,39 @@ namespace
         ret.reset(reinterpret_cast<::uv_handle_t*>(rhs.release()));
         return ret;
     }
+
+    /**
+     * @brief 内部裸句柄的持有者
+     *
+     * 不由AsyncHandle管理的内部句柄（如sendfile、splice转发使用的uv_poll_t）以此作为data，并在指针次高位设置标记。
+     * RunLoop强制关闭所有句柄时据此使用持有者的关闭回调，而不是当作外部库的句柄，保证持有者能够得到释放。
+     * 持有者需要容忍句柄在自身结束前被关闭。
+     */
+    struct InternalHandleOwner
+    {
+        ::uv_close_cb OnClose;
+
+        explicit InternalHandleOwner(::uv_close_cb cb)noexcept
+            : OnClose(cb) {}
+
+        static void* ToData(InternalHandleOwner* owner)noexcept
+        {
+            assert((moe::BitCast<size_t>(owner) & (kTagMask | kAsyncHandleMask)) == 0);
+            return moe::BitCast<void*>(moe::BitCast<size_t>(owner) | kTagMask);
+        }
+
+        static InternalHandleOwner* FromData(void* data)noexcept
+        {
+            auto value = moe::BitCast<size_t>(data);
+            if ((value & (kTagMask | kAsyncHandleMask)) != kTagMask)
+                return nullptr;
+            return moe::BitCast<InternalHandleOwner*>(value & ~kTagMask);
+        }
+
+    private:
+        static const size_t kAsyncHandleMask = ~(~static_cast<size_t>(0) >> 1);  // 见AsyncHandle::HandleToData
+        static const size_t kTagMask = kAsyncHandleMask >> 1;
+    };
 }
 
 #define MOE_UV_GET_SELF(T) \
@@ -53,7 +200,8 @@ namespace
             assert(::uv_is_closing(reinterpret_cast<::uv_handle_s*>(handle))); \
             return; \
         } \
-    } while (false)
+    } while (false); \
+    moe::UV::Tracing::HandleScope moeUVHandleScope(self)
 
 #define MOE_UV_GET_HANDLE(T) \
     if (IsClosing()) \
@@ -88,22 +236,25 @@ namespace
 #endif
 
 #ifndef NDEBUG
-#define MOE_UV_ALLOC(sz) \
-    UniquePooledObject<void> buffer; \
+#define MOE_UV_ALLOC(category, sz) \
+    PooledBuffer buffer; \
     do { \
         auto loop = moe::UV::RunLoop::GetCurrent(); \
         if (!loop) \
             MOE_THROW(InvalidCallException, "RunLoop is not created"); \
-        buffer = loop->GetObjectPool().Alloc((sz), ObjectPool::AllocContext(__FILE__, __LINE__)); \
+        auto moeUVAllocSize = (sz); \
+        buffer = PooledBuffer((category), loop->GetObjectPool().Alloc(moeUVAllocSize, \
+            ObjectPool::AllocContext(__FILE__, __LINE__)), moeUVAllocSize); \
     } while (false)
 #else
-#define MOE_UV_ALLOC(sz) \
-    UniquePooledObject<void> buffer; \
+#define MOE_UV_ALLOC(category, sz) \
+    PooledBuffer buffer; \
     do { \
         auto loop = moe::UV::RunLoop::GetCurrent(); \
         if (!loop) \
             MOE_THROW(InvalidCallException, "RunLoop is not created"); \
-        buffer = loop->GetObjectPool().Alloc(sz); \
+        auto moeUVAllocSize = (sz); \
+        buffer = PooledBuffer((category), loop->GetObjectPool().Alloc(moeUVAllocSize), moeUVAllocSize); \
     } while (false)
 #endif
 
@@ -115,11 +266,21 @@ namespace
         MOE_THROW(moe::ApiException, "libuv error {0}: {1}", status, err); \
     } while (false)
 
+// 若当前线程上存在AsyncLogAppender则异步输出，避免在回调中阻塞
+#define MOE_UV_ASYNC_LOG_ERROR(...) \
+    do { \
+        auto appender = moe::UV::AsyncLogAppender::GetCurrent(); \
+        if (appender) \
+            appender->Log("ERROR", __VA_ARGS__); \
+        else \
+            MOE_LOG_ERROR(__VA_ARGS__); \
+    } while (false)
+
 #define MOE_UV_LOG_ERROR(status) \
     do { \
         if ((status) < 0) { \
             const char* err = ::uv_strerror((status)); \
-            MOE_LOG_ERROR("libuv error {0}: {1}", (status), err); \
+            MOE_UV_ASYNC_LOG_ERROR("libuv error {0}: {1}", (status), err); \
         } \
     } while (false)
 
@@ -130,20 +291,54 @@ namespace
             MOE_UV_THROW(ret); \
     } while (false)
 
+#ifdef _MSC_VER
+#define MOE_UV_FUNCTION __FUNCSIG__
+#else
+#define MOE_UV_FUNCTION __PRETTY_FUNCTION__
+#endif
+
+// 用户回调均经由此处调用，同时用于RunLoop的回调耗时统计及卡顿诊断
 #define MOE_UV_CATCH_ALL_BEGIN \
-    try {
+    { \
+        moe::UV::RunLoop::CallbackScope moeUVCallbackScope(MOE_UV_FUNCTION); \
+        try {
 
 #define MOE_UV_CATCH_ALL_END \
-    } catch (const moe::ExceptionBase& ex) { \
-        MOE_LOG_ERROR("Uncaught exception, desc: {0}", ex); \
-    } \
-    catch (const std::exception& ex) { \
-        MOE_LOG_ERROR("Uncaught exception, desc: {0}", ex.what()); \
-    } \
-    catch (...) { \
-        MOE_LOG_ERROR("Uncaught unknown exception"); \
+        } catch (const moe::ExceptionBase& ex) { \
+            MOE_UV_ASYNC_LOG_ERROR("Uncaught exception, desc: {0}", ex); \
+        } \
+        catch (const std::exception& ex) { \
+            MOE_UV_ASYNC_LOG_ERROR("Uncaught exception, desc: {0}", ex.what()); \
+        } \
+        catch (...) { \
+            MOE_UV_ASYNC_LOG_ERROR("Uncaught unknown exception"); \
+        } \
     }
 
+namespace
+{
+    /**
+     * @brief 设置套接字的SO_BUSY_POLL
+     * @param handle TCP或UDP句柄
+     * @param usec 忙轮询时间（微秒）
+     */
+    inline void SetSocketBusyPoll(::uv_handle_t* handle, unsigned usec)
+    {
+#ifdef SO_BUSY_POLL
+        ::uv_os_fd_t fd;
+        MOE_UV_CHECK(::uv_fileno(handle, &fd));
+
+        int value = static_cast<int>(usec);
+        if (::setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &value, sizeof(value)) != 0)
+            MOE_THROW(moe::ApiException, "setsockopt error {0}", errno);
+#else
+        MOE_UNUSED(handle);
+        MOE_UNUSED(usec);
+        MOE_THROW(moe::InvalidCallException, "Not supported");
+#endif
+    }
+}
+
 #if 0
 template <typename T>
 class RunLoopAllocator
@@ -180,15 +375,14 @@ public:
     pointer allocate(size_type num, const void* hint=nullptr)
     {
         MOE_UNUSED(hint);
-        MOE_UV_ALLOC(num * sizeof(T));
-        return static_cast<T*>(buffer.release());
+        MOE_UV_ALLOC(moe::UV::AllocCategory::Request, num * sizeof(T));
+        return static_cast<T*>(buffer.Release());
     }
 
     void deallocate(pointer p, size_type num)
     {
-        MOE_UNUSED(num);
-        UniquePooledObject<void> object;
-        object.reset(p);
+        PooledBuffer object;
+        object.Adopt(moe::UV::AllocCategory::Request, p, num * sizeof(T));
     }
 
     void construct(pointer p, const T& value) { new((void*)p) T(value); }
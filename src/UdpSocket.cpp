@@ -29,8 +29,9 @@ struct UVSendRequest
 {
     ::uv_udp_send_t Request;
     ::uv_buf_t BufferDesc;
+    AllocAccount Account { AllocCategory::Request, sizeof(UVSendRequest) };
 
-    UniquePooledObject<void> CopiedBuffer;
+    PooledBuffer CopiedBuffer;
     UdpSocket::OnSendCallbackType OnSend;
 };
 
@@ -63,6 +64,12 @@ void UdpSocket::OnUVSend(::uv_udp_send_t* request, int status)noexcept
     }
     else
     {
+        if (self->m_pIoStats)
+        {
+            ++self->m_pIoStats->WriteOps;
+            self->m_pIoStats->BytesWritten += owner->BufferDesc.len;
+        }
+
         // 通知数据发送
         if (owner->OnSend)
         {
@@ -79,10 +86,10 @@ void UdpSocket::OnUVAllocBuffer(::uv_handle_t* handle, size_t suggestedSize, ::u
 
     MOE_UV_CATCH_ALL_BEGIN
         *buf = ::uv_buf_init(nullptr, 0);
-        MOE_UV_ALLOC(suggestedSize);
+        MOE_UV_ALLOC(AllocCategory::ReadBuffer, suggestedSize);
 
         // 所有权移交到uv_buf_t中
-        *buf = ::uv_buf_init(static_cast<char*>(buffer.release()), static_cast<unsigned>(suggestedSize));
+        *buf = ::uv_buf_init(static_cast<char*>(buffer.Release()), static_cast<unsigned>(suggestedSize));
     MOE_UV_CATCH_ALL_END
 }
 
@@ -92,8 +99,8 @@ void UdpSocket::OnUVRecv(::uv_udp_t* handle, ssize_t nread, const ::uv_buf_t* bu
     MOE_UV_GET_SELF(UdpSocket);
 
     // 获取所有权，确保调用后对象释放
-    UniquePooledObject<void> buffer;
-    buffer.reset(buf->base);
+    PooledBuffer buffer;
+    buffer.Adopt(AllocCategory::ReadBuffer, buf->base, buf->len);
 
     if (nread < 0)  // 通知错误发生
     {
@@ -106,6 +113,12 @@ void UdpSocket::OnUVRecv(::uv_udp_t* handle, ssize_t nread, const ::uv_buf_t* bu
     }
     else if (nread > 0)
     {
+        if (self->m_pIoStats)
+        {
+            ++self->m_pIoStats->ReadOps;
+            self->m_pIoStats->BytesRead += static_cast<size_t>(nread);
+        }
+
         if (flags == UV_UDP_PARTIAL || !(addr->sa_family == AF_INET || addr->sa_family == AF_INET6))
             return;  // 不能处理的数据包类型，直接丢包
 
@@ -120,19 +133,28 @@ void UdpSocket::OnUVRecv(::uv_udp_t* handle, ssize_t nread, const ::uv_buf_t* bu
 
         MOE_UV_CATCH_ALL_BEGIN
             // 通知数据读取
-            self->OnData(remote, BytesView(static_cast<const uint8_t*>(buffer.get()), nread));
+            self->OnData(remote, BytesView(static_cast<const uint8_t*>(buffer.Get()), nread));
         MOE_UV_CATCH_ALL_END
     }
 }
 
+UdpSocket::UdpSocket(UniquePooledObject<::uv_handle_s>&& handle)
+    : AsyncHandle(std::move(handle))
+{
+    auto loop = RunLoop::GetCurrent();
+    if (loop && loop->IsIoStatsEnabledByDefault())
+        SetIoStatsEnabled(true);
+}
+
 UdpSocket::UdpSocket(UdpSocket&& org)noexcept
-    : AsyncHandle(std::move(org)), m_pOnError(std::move(org.m_pOnError)), m_pOnData(std::move(org.m_pOnData))
+    : AsyncHandle(std::move(org)), m_pIoStats(std::move(org.m_pIoStats)), m_pOnError(std::move(org.m_pOnError)), m_pOnData(std::move(org.m_pOnData))
 {
 }
 
 UdpSocket& UdpSocket::operator=(UdpSocket&& rhs)noexcept
 {
     AsyncHandle::operator=(std::move(rhs));
+    m_pIoStats = std::move(rhs.m_pIoStats);
     m_pOnError = std::move(rhs.m_pOnError);
     m_pOnData = std::move(rhs.m_pOnData);
     return *this;
@@ -179,6 +201,12 @@ void UdpSocket::SetTTL(int ttl)
     MOE_UV_CHECK(::uv_udp_set_ttl(handle, ttl));
 }
 
+void UdpSocket::SetBusyPoll(unsigned usec)
+{
+    MOE_UV_GET_HANDLE(::uv_handle_t);
+    SetSocketBusyPoll(handle, usec);
+}
+
 void UdpSocket::Bind(const EndPoint& address, bool reuse, bool ipv6Only)
 {
     MOE_UV_GET_HANDLE(::uv_udp_t);
@@ -217,11 +245,11 @@ void UdpSocket::Send(const EndPoint& address, BytesView buf)
     MOE_UV_NEW(UVSendRequest);
 
     // 分配缓冲区并拷贝数据
-    MOE_UV_ALLOC(buf.GetSize());
+    MOE_UV_ALLOC(AllocCategory::WriteCopy, buf.GetSize());
     object->CopiedBuffer = std::move(buffer);
-    object->BufferDesc = ::uv_buf_init(static_cast<char*>(object->CopiedBuffer.get()),
+    object->BufferDesc = ::uv_buf_init(static_cast<char*>(object->CopiedBuffer.Get()),
         static_cast<unsigned>(buf.GetSize()));
-    memcpy(object->CopiedBuffer.get(), buf.GetBuffer(), buf.GetSize());
+    memcpy(object->CopiedBuffer.Get(), buf.GetBuffer(), buf.GetSize());
 
     // 发起写操作
     MOE_UV_CHECK(::uv_udp_send(&object->Request, handle, &(object->BufferDesc), 1,
@@ -230,6 +258,7 @@ void UdpSocket::Send(const EndPoint& address, BytesView buf)
     // 释放所有权，交由UV管理
     ::uv_udp_send_t& req = object->Request;
     req.data = object.release();
+    UpdateSendQueueHighWater(handle);
 }
 
 void UdpSocket::SendNoCopy(const EndPoint& address, BytesView buffer, const OnSendCallbackType& cb)
@@ -250,6 +279,7 @@ void UdpSocket::SendNoCopy(const EndPoint& address, BytesView buffer, const OnSe
     // 释放所有权，交由UV管理
     ::uv_udp_send_t& req = object->Request;
     req.data = object.release();
+    UpdateSendQueueHighWater(handle);
 }
 
 void UdpSocket::SendNoCopy(const EndPoint& address, BytesView buffer, OnSendCallbackType&& cb)
@@ -270,6 +300,7 @@ void UdpSocket::SendNoCopy(const EndPoint& address, BytesView buffer, OnSendCall
     // 释放所有权，交由UV管理
     ::uv_udp_send_t& req = object->Request;
     req.data = object.release();
+    UpdateSendQueueHighWater(handle);
 }
 
 bool UdpSocket::TrySend(const EndPoint& address, BytesView buffer)
@@ -284,14 +315,37 @@ bool UdpSocket::TrySend(const EndPoint& address, BytesView buffer)
     // 发起写操作
     auto r = ::uv_udp_try_send(handle, &desc, 1, reinterpret_cast<const ::sockaddr*>(&address.Storage));
     if (r >= 0)
+    {
+        if (m_pIoStats)
+        {
+            ++m_pIoStats->WriteOps;
+            m_pIoStats->BytesWritten += static_cast<size_t>(r);
+        }
         return true;
+    }
     else if (r == UV_EAGAIN)
         return false;
     MOE_UV_THROW(r);
 }
 
+void UdpSocket::SetIoStatsEnabled(bool enabled)
+{
+    if (!enabled)
+    {
+        m_pIoStats.reset();
+        return;
+    }
+    if (m_pIoStats)
+        return;
+
+    m_pIoStats.reset(new IoStats());
+    m_pIoStats->StartTime = RunLoop::Now();
+}
+
 void UdpSocket::OnError(int error)
 {
+    if (m_pIoStats)
+        ++m_pIoStats->Errors;
     if (m_pOnError)
         m_pOnError(error);
 }
@@ -301,3 +355,13 @@ void UdpSocket::OnData(const EndPoint& remote, BytesView data)
     if (m_pOnData)
         m_pOnData(remote, data);
 }
+
+void UdpSocket::UpdateSendQueueHighWater(::uv_udp_s* handle)noexcept
+{
+    if (!m_pIoStats)
+        return;
+
+    auto size = ::uv_udp_get_send_queue_size(handle);
+    if (size > m_pIoStats->WriteQueueHighWater)
+        m_pIoStats->WriteQueueHighWater = size;
+}